@@ -0,0 +1,155 @@
+#ifndef BAR_SERIES_INL_H_
+#define BAR_SERIES_INL_H_
+
+#ifndef BAR_SERIES_H_
+#error "BarSeries-inl.h" should be included only in "BarSeries.h" file
+#endif
+
+#include <algorithm>
+
+using namespace std;
+
+BarSeries::BarSeries(uint64_t interval, size_t capacity) noexcept
+: total()
+, interval(max<uint64_t>(interval, 1))
+, capacity(max<size_t>(capacity, 1))
+, head(0)
+{
+}
+
+void BarSeries::on_insert(uint64_t time, double price, uint32_t volume) noexcept
+{
+	Bar& bar = current(time);
+	++bar.inserts;
+	add_quote(bar, price, volume);
+
+	++total.inserts;
+	add_quote(total, price, volume);
+}
+
+void BarSeries::on_amend(uint64_t time, double price, uint32_t volume) noexcept
+{
+	Bar& bar = current(time);
+	++bar.amends;
+	add_quote(bar, price, volume);
+
+	++total.amends;
+	add_quote(total, price, volume);
+}
+
+void BarSeries::on_cancel(uint64_t time) noexcept
+{
+	++current(time).cancels;
+	++total.cancels;
+}
+
+size_t BarSeries::size() const noexcept
+{
+	return ring.size();
+}
+
+vector<Bar> BarSeries::get_bars(size_t k) const noexcept
+{
+	const size_t count = ring.size();
+	k = min(k, count);
+
+	vector<Bar> bars;
+	bars.reserve(k);
+	for (size_t i = count - k; i < count; i++)
+		bars.push_back(at(i));
+
+	return bars;
+}
+
+BarColumns BarSeries::get_columns() const noexcept
+{
+	const size_t count = ring.size();
+	BarColumns columns;
+
+	columns.start_time.reserve(count);
+	columns.open.reserve(count);
+	columns.high.reserve(count);
+	columns.low.reserve(count);
+	columns.close.reserve(count);
+	columns.volume.reserve(count);
+	columns.vwap.reserve(count);
+	columns.inserts.reserve(count);
+	columns.cancels.reserve(count);
+	columns.amends.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Bar& bar = at(i);
+		columns.start_time.push_back(bar.start_time);
+		columns.open.push_back(bar.open);
+		columns.high.push_back(bar.high);
+		columns.low.push_back(bar.low);
+		columns.close.push_back(bar.close);
+		columns.volume.push_back(bar.volume);
+		columns.vwap.push_back(bar.vwap());
+		columns.inserts.push_back(bar.inserts);
+		columns.cancels.push_back(bar.cancels);
+		columns.amends.push_back(bar.amends);
+	}
+
+	return columns;
+}
+
+const Bar& BarSeries::get_total() const noexcept
+{
+	return total;
+}
+
+Bar& BarSeries::current(uint64_t time) noexcept
+{
+	const uint64_t start_time = time - time % interval;
+
+	// Same bucket or an event late by up to one interval, both belong to the open bar.
+	// Time going back further, for example after midnight, opens a new bar.
+	if (!ring.empty() && start_time <= ring[head].start_time && ring[head].start_time - start_time <= interval)
+		return ring[head];
+
+	if (ring.size() < capacity)
+	{
+		ring.emplace_back();
+		head = ring.size() - 1;
+	}
+	else
+		head = (head + 1 == ring.size()) ? 0 : head + 1;
+
+	// First event of series opens the total as well
+	if (total.inserts + total.cancels + total.amends == 0)
+		total.start_time = start_time;
+
+	Bar& bar = ring[head];
+	bar = Bar();
+	bar.start_time = start_time;
+	return bar;
+}
+
+void BarSeries::add_quote(Bar& bar, double price, uint32_t volume) noexcept
+{
+	if (bar.inserts + bar.amends == 1)
+	{
+		bar.open = price;
+		bar.high = price;
+		bar.low = price;
+	}
+	else
+	{
+		bar.high = max(bar.high, price);
+		bar.low = min(bar.low, price);
+	}
+
+	bar.close = price;
+	bar.volume += volume;
+	bar.notional += price * volume;
+}
+
+const Bar& BarSeries::at(size_t index) const noexcept
+{
+	// index 0 is the oldest bar, it follows the newest one once the ring is full
+	return ring[(head + 1 + index) % ring.size()];
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef BAR_SERIES_H_
+#define BAR_SERIES_H_
+
+#include <cstdint>
+#include <vector>
+
+/// Struct that contains statistics of one time bucket of a symbol.
+struct Bar
+{
+	uint64_t start_time;
+	double open;
+	double high;
+	double low;
+	double close;
+	uint64_t volume;
+	double notional;
+	uint32_t inserts;
+	uint32_t cancels;
+	uint32_t amends;
+
+	/// Returns volume weighted average price of the bucket or zero when it has no volume.
+	double vwap() const noexcept
+	{
+		return volume == 0 ? 0.0 : notional / volume;
+	}
+};
+
+/// Columnar (struct of arrays) copy of a bar series, oldest bar first.
+struct BarColumns
+{
+	std::vector<uint64_t> start_time;
+	std::vector<double> open;
+	std::vector<double> high;
+	std::vector<double> low;
+	std::vector<double> close;
+	std::vector<uint64_t> volume;
+	std::vector<double> vwap;
+	std::vector<uint32_t> inserts;
+	std::vector<uint32_t> cancels;
+	std::vector<uint32_t> amends;
+};
+
+/**
+ * BarSeries aggregates order events of one symbol into time buckets of fixed interval.
+ * Bars are kept in a ring buffer that grows up to capacity, so a quiet symbol stays small,
+ * and when it is full the oldest bar is overwritten. Buckets without any event are not stored.
+ *
+ * Inserts and amends carry price, so they update open, high, low, close, volume and VWAP.
+ * Cancels are only counted. Events late by up to one interval are folded into the current bucket,
+ * older ones, for example after midnight, open a new bar, so bars are kept in order of arrival.
+ */
+class BarSeries
+{
+public:
+	/**
+	 * @param interval Length of every bucket in microseconds.
+	 * @param capacity Maximum number of bars that are kept.
+	 */
+	inline BarSeries(uint64_t interval, size_t capacity) noexcept;
+
+	/// Records an insert of volume at price
+	inline void on_insert(uint64_t time, double price, uint32_t volume) noexcept;
+
+	/// Records an amend to volume at price
+	inline void on_amend(uint64_t time, double price, uint32_t volume) noexcept;
+
+	/// Records a cancel
+	inline void on_cancel(uint64_t time) noexcept;
+
+	/// Returns number of bars stored
+	inline size_t size() const noexcept;
+
+	/// Returns last `count` bars, oldest first
+	inline std::vector<Bar> get_bars(size_t count) const noexcept;
+
+	/// Returns all stored bars in columnar format, oldest first
+	inline BarColumns get_columns() const noexcept;
+
+	/// Returns one bar of every event ever recorded, it is not limited by capacity
+	inline const Bar& get_total() const noexcept;
+
+private:
+	inline Bar& current(uint64_t time) noexcept;
+
+	inline static void add_quote(Bar& bar, double price, uint32_t volume) noexcept;
+
+	inline const Bar& at(size_t index) const noexcept;
+
+	std::vector<Bar> ring;
+	Bar total;
+	uint64_t interval;
+	size_t capacity;
+	size_t head;
+};
+
+#include "BarSeries-inl.h"
+
+#endif
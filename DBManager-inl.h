@@ -5,11 +5,20 @@
 #error "DBManager-inl.h" should be included only in "DBManager.h" file
 #endif
 
+#include <algorithm>
+
 #include "Logger.h"
 
 using namespace std;
 
-DBManager::Key DBManager::fill_key(DBManager::ConstStringArray<COMMAND_PART_COUNT>& parts) noexcept
+DBManager::DBManager(uint64_t bar_interval, size_t bar_capacity) noexcept
+: compact_time(0)
+, bar_interval(bar_interval)
+, bar_capacity(bar_capacity)
+{
+}
+
+DBManager::Key DBManager::fill_key(const DBManager::Fields& parts) noexcept
 {
 	enum FieldIndex
 	{
@@ -19,7 +28,7 @@ DBManager::Key DBManager::fill_key(DBManager::ConstStringArray<COMMAND_PART_COUN
 	
 	DBManager::Key key;
 
-	key.symbol = parts[SYMBOL_INDEX];
+	key.symbol.assign(parts[SYMBOL_INDEX].data, parts[SYMBOL_INDEX].size);
 	if (parts[SIDE_INDEX] == "BUY")
 		key.side = Side::BUY;
 	else if (parts[SIDE_INDEX] == "SELL")
@@ -33,7 +42,7 @@ DBManager::Key DBManager::fill_key(DBManager::ConstStringArray<COMMAND_PART_COUN
 	return key;
 }
 
-DBManager::Order DBManager::fill_order(DBManager::ConstStringArray<COMMAND_PART_COUNT>& parts) noexcept
+bool DBManager::fill_order(const DBManager::Fields& parts, DBManager::Order& order) noexcept
 {
 	enum FieldIndex
 	{
@@ -43,24 +52,27 @@ DBManager::Order DBManager::fill_order(DBManager::ConstStringArray<COMMAND_PART_
 		PRICE_INDEX = 6
 	};
 
-	DBManager::Order order;
+	order.time.assign(parts[TIME_INDEX].data, parts[TIME_INDEX].size);
+	order.timestamp = to_microseconds(order.time);
 
-	order.time = parts[TIME_INDEX];
-	order.id = stol(parts[ID_INDEX]);
-	order.volume = stol(parts[VOLUME_INDEX]);
-	order.price = stod(parts[PRICE_INDEX]);
+	if (!parse_integer(parts[ID_INDEX], order.id) || !parse_integer(parts[VOLUME_INDEX], order.volume) ||
+		!parse_price(parts[PRICE_INDEX], order.price))
+	{
+		Logger::error("DBManager::fill_order(): Invalid number.");
+		return false;
+	}
 
 	if (order.price < 0)
 		Logger::error("DBManager::fill_order(): Negative value for price.");
 
-	return order;
+	return true;
 }
 
-DBManager::Instruction DBManager::get_instruction(DBManager::ConstStringArray<COMMAND_PART_COUNT>& parts) noexcept
+DBManager::Instruction DBManager::get_instruction(const DBManager::Fields& parts) noexcept
 {
 	static constexpr size_t INSTRUCTION_INDEX = 3;
 
-	const string instruction = parts[INSTRUCTION_INDEX];
+	const Field& instruction = parts[INSTRUCTION_INDEX];
 	if (instruction == "I")
 		return Instruction::INSERT;
 	else if (instruction == "C")
@@ -71,46 +83,252 @@ DBManager::Instruction DBManager::get_instruction(DBManager::ConstStringArray<CO
 		return Instruction::UNKNOW;
 }
 
-template<int N>
-DBManager::StringArray<N> DBManager::split(const string& info, const string& delimiter) noexcept
+bool DBManager::parse_integer(const DBManager::Field& field, uint32_t& value) noexcept
+{
+	if (field.size == 0 || field.size > 10)
+		return false;
+
+	uint64_t result = 0;
+	for (size_t i = 0; i < field.size; i++)
+	{
+		const unsigned digit = static_cast<unsigned char>(field.data[i]) - '0';
+		if (digit > 9)
+			return false;
+		result = result * 10 + digit;
+	}
+
+	value = static_cast<uint32_t>(result);
+	return result <= UINT32_MAX;
+}
+
+bool DBManager::parse_price(const DBManager::Field& field, double& value) noexcept
+{
+	// Digits are collected as an integer and divided once, which rounds like strtod for short prices
+	static constexpr double POWERS_OF_TEN[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+	static constexpr size_t MAX_DIGITS = 15;
+
+	size_t i = 0;
+	const bool negative = field.size != 0 && field.data[0] == '-';
+	if (negative)
+		++i;
+
+	uint64_t mantissa = 0;
+	size_t digits = 0;
+	size_t fraction_digits = 0;
+	bool has_point = false;
+
+	for (; i < field.size; i++)
+	{
+		const char c = field.data[i];
+		if (c == '.' && !has_point)
+		{
+			has_point = true;
+			continue;
+		}
+
+		const unsigned digit = static_cast<unsigned char>(c) - '0';
+		if (digit > 9 || ++digits > MAX_DIGITS)
+			return false;
+
+		mantissa = mantissa * 10 + digit;
+		fraction_digits += has_point;
+	}
+
+	if (digits == 0)
+		return false;
+
+	value = mantissa / POWERS_OF_TEN[fraction_digits];
+	if (negative)
+		value = -value;
+	return true;
+}
+
+uint64_t DBManager::to_microseconds(const string& time) noexcept
+{
+	// Format is HH:MM:SS.ffffff, the fraction may be shorter or missing
+	static constexpr uint64_t MULTIPLIERS[] = {3600000000ULL, 60000000ULL, 1000000ULL};
+	static constexpr size_t FRACTION_DIGITS = 6;
+
+	uint64_t microseconds = 0;
+	uint64_t field = 0;
+	size_t field_index = 0;
+	size_t i = 0;
+
+	for (; i < time.size() && time[i] != '.'; i++)
+	{
+		if (time[i] == ':')
+		{
+			if (field_index < 2)
+				microseconds += field * MULTIPLIERS[field_index++];
+			field = 0;
+		}
+		else
+			field = field * 10 + static_cast<uint64_t>(time[i] - '0');
+	}
+	microseconds += field * MULTIPLIERS[field_index];
+
+	uint64_t fraction = 0;
+	size_t digits = 0;
+	for (++i; i < time.size() && digits < FRACTION_DIGITS; i++, digits++)
+		fraction = fraction * 10 + static_cast<uint64_t>(time[i] - '0');
+	for (; digits < FRACTION_DIGITS; digits++)
+		fraction *= 10;
+
+	return microseconds + fraction;
+}
+
+uint64_t DBManager::get_level_key(DBManager::Side side, const DBManager::Order& order) noexcept
+{
+	// Best buy level is the highest price and best sell level is the lowest one
+	return side == Side::BUY ? MaxByPrice::key(order) : MinByPrice::key(order);
+}
+
+BarSeries& DBManager::get_bar_series(const string& symbol) noexcept
+{
+	auto search = bars.find(symbol);
+	if (search != bars.end())
+		return search->second;
+
+	return bars.emplace(symbol, BarSeries(bar_interval, bar_capacity)).first->second;
+}
+
+template<typename T>
+void DBManager::write_column(ostream& out, const string& name, const vector<T>& column) noexcept
 {
-	size_t start_index = 0;
-	size_t end_index = info.find(delimiter, start_index);
+	out << name;
+	for (auto& value : column)
+		out << ' ' << value;
+	out << '\n';
+}
+
+bool DBManager::split(const char* command, size_t length, DBManager::Fields& parts, char delimiter) noexcept
+{
+	const char* end = command + length;
+	const char* start = command;
 	size_t index = 0;
 
-	DBManager::StringArray<N> output;
-	
-	while ((end_index = info.find(delimiter, start_index)) != string::npos)
+	for (const char* position = command; position != end; ++position)
 	{
-		output[index++] = info.substr(start_index, end_index - start_index);
-		start_index = end_index + delimiter.size();
+		if (*position != delimiter)
+			continue;
+
+		if (index == COMMAND_PART_COUNT - 1)
+			return false;
+
+		parts[index++] = {start, static_cast<size_t>(position - start)};
+		start = position + 1;
 	}
 
-	output[index] = info.substr(start_index, end_index - start_index);
-	return output;
+	parts[index++] = {start, static_cast<size_t>(end - start)};
+	return index == COMMAND_PART_COUNT;
 }
 
 bool DBManager::execute_command(const string& command) noexcept
 {
-	DBManager::StringArray<COMMAND_PART_COUNT> parts = split<COMMAND_PART_COUNT>(command);
+	return execute_command(command.data(), command.size());
+}
+
+bool DBManager::execute_command(const char* command, size_t length) noexcept
+{
+	// Line terminator of files written on Windows
+	while (length != 0 && (command[length - 1] == '\r' || command[length - 1] == '\n'))
+		--length;
+
+	DBManager::Fields parts;
+	if (!split(command, length, parts))
+	{
+		Logger::error("DBManager::execute_command(): Invalid command format.");
+		return false;
+	}
 	
 	DBManager::Key key = fill_key(parts);
-	DBManager::Order order = fill_order(parts);
+	if (key.side == Side::UNKNOW)
+		return false;
+
+	DBManager::Order order;
+	if (!fill_order(parts, order))
+		return false;
+
 	Instruction instruction = get_instruction(parts);
+
+	// Small steps back come from clients with skewed clocks, a large one is a new day
+	const bool is_due = order.timestamp < compact_time ? compact_time - order.timestamp > ROLLOVER
+		: order.timestamp - compact_time >= COMPACT_INTERVAL;
+
+	if (is_due)
+		compact(order.timestamp);
 	
 	if (instruction == Instruction::INSERT)
-		table[key].insert(order);
+	{
+		Book& book = table[key];
+		if (book.orders.insert(order))
+			book.ladder.add(get_level_key(key.side, order), order.price, order.volume);
+		list_hot(book);
+		get_bar_series(key.symbol).on_insert(order.timestamp, order.price, order.volume);
+	}
 	else if (instruction == Instruction::CANCEL)
 	{
-		table[key].remove(order);
+		Book& book = table[key];
+		const Order* old = book.orders.find(order.id);
+		if (old)
+			book.ladder.remove(get_level_key(key.side, *old), old->volume);
+		book.orders.remove(order);
+		get_bar_series(key.symbol).on_cancel(order.timestamp);
 	}
 	else if (instruction == Instruction::AMEND)
 	{
-		table[key].update(order);
+		Book& book = table[key];
+		const Order* old = book.orders.find(order.id);
+		if (old)
+		{
+			book.ladder.remove(get_level_key(key.side, *old), old->volume);
+			book.ladder.add(get_level_key(key.side, order), order.price, order.volume);
+		}
+		book.orders.update(order);
+		list_hot(book);
+		get_bar_series(key.symbol).on_amend(order.timestamp, order.price, order.volume);
 	}
 	else
 	{
 		Logger::error("DBManager::execute_command(): Unknown Instruction.");
+		return false;
+	}
+
+	return true;
+}
+
+void DBManager::compact(const string& time) noexcept
+{
+	compact(to_microseconds(time));
+}
+
+void DBManager::compact(uint64_t time) noexcept
+{
+	// Demoted books leave the list, nodes of the table do not move so pointers stay valid
+	for (size_t i = 0; i < hot_books.size();)
+	{
+		Book& book = *hot_books[i];
+		book.orders.compact(time);
+		if (book.orders.is_hot())
+		{
+			++i;
+			continue;
+		}
+
+		book.is_listed = false;
+		hot_books[i] = hot_books.back();
+		hot_books.pop_back();
+	}
+
+	compact_time = time;
+}
+
+void DBManager::list_hot(Book& book) noexcept
+{
+	if (!book.is_listed && book.orders.is_hot())
+	{
+		book.is_listed = true;
+		hot_books.push_back(&book);
 	}
 }
 
@@ -119,7 +337,7 @@ unordered_map<string, size_t> DBManager::get_orders_count() const noexcept
 	unordered_map<string, size_t> counts;
 
 	for (auto& row : table)
-		counts[row.first.symbol] += row.second.get_orders_count();
+		counts[row.first.symbol] += row.second.orders.get_orders_count();
 
 	return counts;
 }
@@ -136,7 +354,7 @@ vector<size_t> DBManager::get_biggest_buy_order(const string& symbol, size_t k)
 	}
 
 	vector<size_t> orders_volume;
-	for (auto& order : search->second.get_top_items(k))
+	for (auto& order : search->second.orders.get_top_items(k))
 		orders_volume.push_back(order.volume);
 
 	return orders_volume;
@@ -144,9 +362,8 @@ vector<size_t> DBManager::get_biggest_buy_order(const string& symbol, size_t k)
 
 tuple<size_t, size_t, bool> DBManager::get_best_sell_at_time(const string& symbol, const string& time) const noexcept
 {
-	static auto match = [](const DBManager::Order& order, const string& time) {
-		//return order.time.find(time) != string::npos;
-		return order.time < time;
+	static auto match = [](const DBManager::Order& order, uint64_t timestamp) {
+		return order.timestamp < timestamp;
 	};
 
 	static auto compare = [](const DBManager::Order& order1, const DBManager::Order& order2)
@@ -163,8 +380,93 @@ tuple<size_t, size_t, bool> DBManager::get_best_sell_at_time(const string& symbo
 		return make_tuple(0, 0, false);
 	}
 
-	auto order_pair = table.at(key).filter(time, match, compare);
+	auto order_pair = search->second.orders.filter(to_microseconds(time), match, compare);
 	return make_tuple(order_pair.first.price, order_pair.first.volume , order_pair.second);
 }
 
+DBManager::Depth DBManager::get_depth(const string& symbol, size_t levels) const noexcept
+{
+	Depth depth;
+	get_depth(symbol, levels, depth);
+	return depth;
+}
+
+void DBManager::get_depth(const string& symbol, size_t levels, Depth& depth) const noexcept
+{
+	depth.bids.clear();
+	depth.asks.clear();
+
+	auto bids = table.find(Key{symbol, Side::BUY});
+	if (bids != table.end())
+		bids->second.ladder.get_depth(levels, depth.bids);
+
+	auto asks = table.find(Key{symbol, Side::SELL});
+	if (asks != table.end())
+		asks->second.ladder.get_depth(levels, depth.asks);
+
+	if (bids == table.end() && asks == table.end())
+		Logger::warning("DBManager::get_depth(): symbol %s  not found.", symbol.c_str());
+}
+
+vector<Bar> DBManager::get_bars(const string& symbol, size_t count) const noexcept
+{
+	auto search = bars.find(symbol);
+	if (search == bars.end())
+	{
+		Logger::warning("DBManager::get_bars(): symbol %s  not found.", symbol.c_str());
+		return vector<Bar>();
+	}
+
+	return search->second.get_bars(count);
+}
+
+Bar DBManager::get_bar_total(const string& symbol) const noexcept
+{
+	auto search = bars.find(symbol);
+	if (search == bars.end())
+	{
+		Logger::warning("DBManager::get_bar_total(): symbol %s  not found.", symbol.c_str());
+		return Bar();
+	}
+
+	return search->second.get_total();
+}
+
+BarColumns DBManager::get_bar_columns(const string& symbol) const noexcept
+{
+	auto search = bars.find(symbol);
+	if (search == bars.end())
+	{
+		Logger::warning("DBManager::get_bar_columns(): symbol %s  not found.", symbol.c_str());
+		return BarColumns();
+	}
+
+	return search->second.get_columns();
+}
+
+void DBManager::dump_bars(ostream& out) const noexcept
+{
+	vector<string> symbols;
+	symbols.reserve(bars.size());
+	for (auto& row : bars)
+		symbols.push_back(row.first);
+	sort(symbols.begin(), symbols.end());
+
+	for (auto& symbol : symbols)
+	{
+		const BarColumns columns = bars.at(symbol).get_columns();
+
+		write_column(out, symbol + ".start_time", columns.start_time);
+		write_column(out, symbol + ".open", columns.open);
+		write_column(out, symbol + ".high", columns.high);
+		write_column(out, symbol + ".low", columns.low);
+		write_column(out, symbol + ".close", columns.close);
+		write_column(out, symbol + ".volume", columns.volume);
+		write_column(out, symbol + ".vwap", columns.vwap);
+		write_column(out, symbol + ".inserts", columns.inserts);
+		write_column(out, symbol + ".cancels", columns.cancels);
+		write_column(out, symbol + ".amends", columns.amends);
+	}
+}
+
 #endif
@@ -2,23 +2,45 @@
 #define DB_MANAGER_H_
 
 #include <array>
+#include <cstring>
+#include <ostream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include <tuple>
 
-#include "PriorityQueue.h"
+#include "BarSeries.h"
+#include "PriceLadder.h"
+#include "TieredBook.h"
 
 /// DBManager manage parsing transactions and connection to the data structure that saves information.
 class DBManager
 {
 	static constexpr size_t COMMAND_PART_COUNT = 7;
 
-	template<int N>
-	using StringArray = std::array<std::string, N>;
+	static constexpr uint64_t DEFAULT_BAR_INTERVAL = 60 * 1000000;
 
-	template<int N>
-	using ConstStringArray = const std::array<std::string, N>;
+	static constexpr size_t DEFAULT_BAR_CAPACITY = 512;
+
+	/// Order time between two sweeps of hot books, one rate window of tiered books
+	static constexpr uint64_t COMPACT_INTERVAL = DefaultTiering::RATE_WINDOW;
+
+	/// Order time going back by more than this starts a new day
+	static constexpr uint64_t ROLLOVER = DefaultTiering::ROLLOVER;
+
+	/// Struct that points to one part of a command inside the command buffer
+	struct Field
+	{
+		const char* data;
+		size_t size;
+
+		bool operator==(const char* text) const noexcept
+		{
+			return std::strncmp(data, text, size) == 0 && text[size] == '\0';
+		}
+	};
+
+	typedef std::array<Field, COMMAND_PART_COUNT> Fields;
 
 	/// Enum class represent transactions instruction type.
 	enum class Instruction : uint8_t
@@ -42,6 +64,7 @@ class DBManager
 	{
 		uint32_t id;
 		std::string time;
+		uint64_t timestamp;
 		uint32_t volume;
 		double price;
 		
@@ -54,16 +77,6 @@ class DBManager
 		{
 			return id == p.id;
 		}
-
-		bool operator<(const Order& p) const noexcept
-		{
-			return volume > p.volume;
-		}
-
-		bool operator>(const Order& p) const noexcept
-		{
-			return volume < p.volume;
-		}
 	};
 
 	/**
@@ -94,6 +107,19 @@ class DBManager
 
 
 public:
+	/// Struct that contains aggregated depth of both sides of a symbol, best level first
+	struct Depth
+	{
+		std::vector<PriceLevel> bids;
+		std::vector<PriceLevel> asks;
+	};
+
+	/**
+	 * @param bar_interval Length of OHLCV bars in microseconds.
+	 * @param bar_capacity Number of bars kept per symbol, older bars are overwritten.
+	 */
+	inline explicit DBManager(uint64_t bar_interval = DEFAULT_BAR_INTERVAL, size_t bar_capacity = DEFAULT_BAR_CAPACITY) noexcept;
+
 	/**
 	 * API for executing command. It parse the command and handle transaction to database.
 	 *
@@ -103,6 +129,25 @@ public:
 	 */
 	inline bool execute_command(const std::string& command) noexcept;
 
+	/**
+	 * API for executing command that is read into a buffer. It parses the command in place.
+	 *
+	 * @param command Pointer to a command in format of [timestamp; symbol; id; instruction; side; volume; price]
+	 * @param length Length of command, without line terminator
+	 *
+	 * @return true if command is in correct format and proper values. otherwise return false. 
+	 */
+	inline bool execute_command(const char* command, size_t length) noexcept;
+
+	/**
+	 * API for demoting hot books that have been quiet for a rate window, even if they get no more
+	 * commands. Commands already do it once per COMPACT_INTERVAL of order time and on a new day.
+	 * Only hot books are visited, cold books end their windows on their own commands.
+	 *
+	 * @param time Current time in format of [HH:MM:SS.ffffff]
+	 */
+	inline void compact(const std::string& time) noexcept;
+
 	/**
 	 * API for getting number of orders per symbol.
 	 *
@@ -130,19 +175,105 @@ public:
 	 */
 	inline std::tuple<size_t, size_t, bool> get_best_sell_at_time(const std::string& symbol, const std::string& time) const noexcept;
 
+	/**
+	 * API for getting depth of book of a symbol. Ladders are kept while commands are executed,
+	 * so this only copies the best levels.
+	 *
+	 * @param Symbol that want to fetch its depth
+	 * @param levels Maximum number of price levels of each side.
+	 *
+	 * @return Aggregated volume and order count per price of buy and sell side.
+	 */
+	inline Depth get_depth(const std::string& symbol, size_t levels = 10) const noexcept;
+
+	/**
+	 * Same as above, but fills depth of the caller, so a reused Depth is not allocated again.
+	 * It does not change the manager, so it may be called from many threads while no command runs.
+	 */
+	inline void get_depth(const std::string& symbol, size_t levels, Depth& depth) const noexcept;
+
+	/**
+	 * API for getting last OHLCV bars of a symbol.
+	 *
+	 * @param Symbol that want to fetch its bars
+	 * @param count Maximum number of bars to be fetched.
+	 *
+	 * @return A vector of bars, oldest first.
+	 */
+	inline std::vector<Bar> get_bars(const std::string& symbol, size_t count = DEFAULT_BAR_CAPACITY) const noexcept;
+
+	/**
+	 * API for getting totals of a symbol since the first command, older bars dropped from
+	 * the ring buffer are still counted.
+	 *
+	 * @param Symbol that want to fetch its totals
+	 *
+	 * @return One bar that covers every command of symbol. It is empty if symbol not found.
+	 */
+	inline Bar get_bar_total(const std::string& symbol) const noexcept;
+
+	/**
+	 * API for getting all stored bars of a symbol in columnar format.
+	 *
+	 * @param Symbol that want to fetch its bars
+	 *
+	 * @return Columns of bars, oldest first. Columns are empty if symbol not found.
+	 */
+	inline BarColumns get_bar_columns(const std::string& symbol) const noexcept;
+
+	/**
+	 * API for dumping bars of all symbols. Every line holds one column of a symbol
+	 * in format of [symbol.column value value ...], symbols are sorted.
+	 *
+	 * @param out Stream that bars are written to.
+	 */
+	inline void dump_bars(std::ostream& out) const noexcept;
+
 private:
-	typedef std::unordered_map<Key, PriorityQueue<Order, uint32_t>, hash_fn> Table;
+	/// Orders of one side of a symbol, ordered by volume and aggregated per price
+	struct Book
+	{
+		TieredBook<Order, uint32_t, MaxByVolume> orders;
+		PriceLadder ladder;
+		bool is_listed = false;
+	};
+
+	typedef std::unordered_map<Key, Book, hash_fn> Table;
+
+	typedef std::unordered_map<std::string, BarSeries> Bars;
+
+	inline static Key fill_key(const Fields& parts) noexcept;
 
-	inline static Key fill_key(ConstStringArray<COMMAND_PART_COUNT>& parts) noexcept;
+	inline static bool fill_order(const Fields& parts, Order& order) noexcept;
 
-	inline static Order fill_order(ConstStringArray<COMMAND_PART_COUNT>& parts) noexcept;
+	inline static Instruction get_instruction(const Fields& parts) noexcept;
 
-	inline static Instruction get_instruction(ConstStringArray<COMMAND_PART_COUNT>& parts) noexcept;
+	inline static bool parse_integer(const Field& field, uint32_t& value) noexcept;
 
-	template<int N>
-	inline static StringArray<N> split(const std::string& info, const std::string& delimiter = ";") noexcept;
+	inline static bool parse_price(const Field& field, double& value) noexcept;
+
+	inline static uint64_t to_microseconds(const std::string& time) noexcept;
+
+	inline static uint64_t get_level_key(Side side, const Order& order) noexcept;
+
+	inline BarSeries& get_bar_series(const std::string& symbol) noexcept;
+
+	inline void compact(uint64_t time) noexcept;
+
+	inline void list_hot(Book& book) noexcept;
+
+	template<typename T>
+	inline static void write_column(std::ostream& out, const std::string& name, const std::vector<T>& column) noexcept;
+
+	inline static bool split(const char* command, size_t length, Fields& parts, char delimiter = ';') noexcept;
 	
 	Table table;
+	std::vector<Book*> hot_books;
+	uint64_t compact_time;
+
+	Bars bars;
+	uint64_t bar_interval;
+	size_t bar_capacity;
 };
 
 #include "DBManager-inl.h"
@@ -0,0 +1,346 @@
+#ifndef GATEWAY_INL_H_
+#define GATEWAY_INL_H_
+
+#ifndef GATEWAY_H_
+#error "Gateway-inl.h" should be included only in "Gateway.h" file
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Logger.h"
+
+using namespace std;
+
+Gateway::Gateway(DBManager& manager) noexcept
+: manager(manager)
+, epoll_fd(epoll_create1(EPOLL_CLOEXEC))
+, stop_fd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+, commands_count(0)
+{
+	if (epoll_fd < 0 || stop_fd < 0)
+	{
+		Logger::critical("Gateway::Gateway(): can not create epoll: %s", strerror(errno));
+		return;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = stop_fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_ADD, stop_fd, &event);
+}
+
+Gateway::~Gateway() noexcept
+{
+	for (auto& connection : connections)
+		if (connection)
+			close(connection->fd);
+
+	for (auto fd : listeners)
+		close(fd);
+
+	for (auto& path : unix_paths)
+		unlink(path.c_str());
+
+	if (stop_fd >= 0)
+		close(stop_fd);
+
+	if (epoll_fd >= 0)
+		close(epoll_fd);
+}
+
+bool Gateway::listen_unix(const string& path) noexcept
+{
+	sockaddr_un address = {};
+	if (path.size() >= sizeof(address.sun_path))
+	{
+		Logger::error("Gateway::listen_unix(): path %s is too long.", path.c_str());
+		return false;
+	}
+
+	address.sun_family = AF_UNIX;
+	memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	unlink(path.c_str());
+
+	if (fd < 0 || bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+	{
+		Logger::error("Gateway::listen_unix(): can not listen on %s: %s", path.c_str(), strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		return false;
+	}
+
+	unix_paths.push_back(path);
+	return add_listener(fd);
+}
+
+bool Gateway::listen_tcp(uint16_t port) noexcept
+{
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	int reuse = 1;
+	if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0 ||
+		bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(fd, SOMAXCONN) != 0)
+	{
+		Logger::error("Gateway::listen_tcp(): can not listen on port %u: %s", port, strerror(errno));
+		if (fd >= 0)
+			close(fd);
+		return false;
+	}
+
+	return add_listener(fd);
+}
+
+void Gateway::run() noexcept
+{
+	epoll_event events[MAX_EVENTS];
+	vector<Connection*> batch;
+	batch.reserve(MAX_EVENTS);
+
+	for (bool running = true; running; )
+	{
+		const int count = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			Logger::critical("Gateway::run(): epoll_wait failed: %s", strerror(errno));
+			return;
+		}
+
+		batch.clear();
+		for (int i = 0; i < count; i++)
+		{
+			const int fd = events[i].data.fd;
+
+			if (fd == stop_fd)
+				running = false;
+			else if (find(listeners.begin(), listeners.end(), fd) != listeners.end())
+				accept_connections(fd);
+			else
+			{
+				// Draining answers may let commands left in the input buffer run
+				Connection& connection = *connections[fd];
+				if (events[i].events & EPOLLOUT)
+					flush(connection);
+				if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+					receive(connection);
+				batch.push_back(&connection);
+			}
+		}
+
+		for (auto connection : batch)
+			execute(*connection);
+
+		for (auto connection : batch)
+		{
+			flush(*connection);
+			if (connection->is_closed)
+				close_connection(*connection);
+			else
+				update_interest(*connection);
+		}
+	}
+}
+
+void Gateway::stop() noexcept
+{
+	const uint64_t value = 1;
+	ssize_t written = write(stop_fd, &value, sizeof(value));
+	(void)written;
+}
+
+size_t Gateway::get_commands_count() const noexcept
+{
+	return commands_count;
+}
+
+bool Gateway::add_listener(int fd) noexcept
+{
+	epoll_event event = {};
+	event.events = EPOLLIN;
+	event.data.fd = fd;
+
+	if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+	{
+		Logger::error("Gateway::add_listener(): %s", strerror(errno));
+		close(fd);
+		return false;
+	}
+
+	listeners.push_back(fd);
+	return true;
+}
+
+void Gateway::accept_connections(int listener) noexcept
+{
+	for (;;)
+	{
+		int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (fd < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				Logger::warning("Gateway::accept_connections(): %s", strerror(errno));
+			return;
+		}
+
+		int no_delay = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+		if (connections.size() <= static_cast<size_t>(fd))
+			connections.resize(fd + 1);
+
+		connections[fd].reset(new Connection());
+		Connection& connection = *connections[fd];
+		connection.fd = fd;
+		connection.input.resize(BUFFER_SIZE);
+		connection.input_size = 0;
+		connection.output.resize(BUFFER_SIZE);
+		connection.output_size = 0;
+		connection.interest = EPOLLIN;
+		connection.is_closed = false;
+
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.fd = fd;
+		if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0)
+		{
+			Logger::warning("Gateway::accept_connections(): %s", strerror(errno));
+			close(fd);
+			connections[fd].reset();
+		}
+	}
+}
+
+void Gateway::receive(Connection& connection) noexcept
+{
+	// Level triggered epoll wakes the connection again for data left in the socket
+	while (!connection.is_closed && connection.output_size < OUTPUT_LIMIT)
+	{
+		if (connection.input_size == connection.input.size())
+		{
+			execute(connection);
+			if (connection.input_size == connection.input.size())
+			{
+				if (memchr(connection.input.data(), '\n', connection.input_size) == nullptr)
+				{
+					Logger::warning("Gateway::receive(): command is longer than buffer.");
+					connection.is_closed = true;
+				}
+				return;
+			}
+		}
+
+		const ssize_t size = read(connection.fd, connection.input.data() + connection.input_size,
+			connection.input.size() - connection.input_size);
+
+		if (size > 0)
+			connection.input_size += size;
+		else if (size == 0)
+			connection.is_closed = true;
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return;
+		else if (errno != EINTR)
+			connection.is_closed = true;
+	}
+}
+
+void Gateway::execute(Connection& connection) noexcept
+{
+	static const char OK[] = "OK\n";
+	static const char ERR[] = "ERR\n";
+
+	const char* begin = connection.input.data();
+	const char* end = begin + connection.input_size;
+	const char* line = begin;
+
+	// Commands run only while their answers fit, the rest waits in the input buffer
+	for (const char* position; connection.output_size + MAX_ANSWER_SIZE <= connection.output.size() &&
+		(position = static_cast<const char*>(memchr(line, '\n', end - line))) != nullptr; line = position + 1)
+	{
+		const bool is_done = manager.execute_command(line, position - line);
+		++commands_count;
+
+		const char* answer = is_done ? OK : ERR;
+		const size_t answer_size = is_done ? sizeof(OK) - 1 : sizeof(ERR) - 1;
+
+		memcpy(connection.output.data() + connection.output_size, answer, answer_size);
+		connection.output_size += answer_size;
+	}
+
+	// Keeps the commands not run yet at the beginning of buffer
+	connection.input_size = end - line;
+	memmove(connection.input.data(), line, connection.input_size);
+}
+
+void Gateway::flush(Connection& connection) noexcept
+{
+	size_t sent = 0;
+	while (sent < connection.output_size)
+	{
+		const ssize_t size = ::send(connection.fd, connection.output.data() + sent, connection.output_size - sent, MSG_NOSIGNAL);
+
+		if (size >= 0)
+			sent += size;
+		else if (errno == EAGAIN || errno == EWOULDBLOCK)
+			break;
+		else if (errno != EINTR)
+		{
+			connection.is_closed = true;
+			return;
+		}
+	}
+
+	connection.output_size -= sent;
+	memmove(connection.output.data(), connection.output.data() + sent, connection.output_size);
+}
+
+void Gateway::update_interest(Connection& connection) noexcept
+{
+	// Stops reading while too many answers are pending and waits for the socket to be writable
+	// Commands left in the input buffer run on the next wakeup
+	uint32_t interest = 0;
+	if (connection.output_size < OUTPUT_LIMIT)
+		interest |= EPOLLIN;
+	if (connection.output_size != 0 || memchr(connection.input.data(), '\n', connection.input_size) != nullptr)
+		interest |= EPOLLOUT;
+
+	if (interest == connection.interest)
+		return;
+
+	connection.interest = interest;
+
+	epoll_event event = {};
+	event.events = interest;
+	event.data.fd = connection.fd;
+	epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void Gateway::close_connection(Connection& connection) noexcept
+{
+	const int fd = connection.fd;
+
+	epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+	close(fd);
+	connections[fd].reset();
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef GATEWAY_H_
+#define GATEWAY_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DBManager.h"
+
+/**
+ * Gateway is an event driven order entry service. It accepts connections on a Unix domain
+ * socket and/or a loopback TCP port and reads commands in the same line format as order files.
+ * Every command is answered with a line "OK" or "ERR" in the order that commands arrive.
+ *
+ * Commands are parsed in place from receive buffers. Receive and send buffers are allocated once
+ * per connection. All commands read in one wakeup of epoll are executed as a batch before answers
+ * are sent. A client that does not read its answers is not read from until answers drain.
+ */
+class Gateway
+{
+	static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+	static constexpr size_t MAX_EVENTS = 64;
+
+	/// Pending answers above which the connection is not read
+	static constexpr size_t OUTPUT_LIMIT = BUFFER_SIZE / 2;
+
+	/// Longest answer, "ERR\n"
+	static constexpr size_t MAX_ANSWER_SIZE = 4;
+
+	/// Struct that holds state of one client connection
+	struct Connection
+	{
+		int fd;
+		std::vector<char> input;
+		size_t input_size;
+		std::vector<char> output;
+		size_t output_size;
+		uint32_t interest;
+		bool is_closed;
+	};
+
+public:
+	inline explicit Gateway(DBManager& manager) noexcept;
+
+	inline ~Gateway() noexcept;
+
+	Gateway(const Gateway&) = delete;
+	Gateway& operator=(const Gateway&) = delete;
+
+	/// Listens on a Unix domain socket at path, an existing file at path is replaced
+	inline bool listen_unix(const std::string& path) noexcept;
+
+	/// Listens on 127.0.0.1 at port
+	inline bool listen_tcp(uint16_t port) noexcept;
+
+	/// Serves clients until stop() is called
+	inline void run() noexcept;
+
+	/// Makes run() return. It is safe to call from a signal handler or another thread.
+	inline void stop() noexcept;
+
+	/// Returns number of commands executed
+	inline size_t get_commands_count() const noexcept;
+
+private:
+	inline bool add_listener(int fd) noexcept;
+
+	inline void accept_connections(int listener) noexcept;
+
+	inline void receive(Connection& connection) noexcept;
+
+	inline void execute(Connection& connection) noexcept;
+
+	inline void flush(Connection& connection) noexcept;
+
+	inline void update_interest(Connection& connection) noexcept;
+
+	inline void close_connection(Connection& connection) noexcept;
+
+	DBManager& manager;
+
+	int epoll_fd;
+	int stop_fd;
+	std::vector<int> listeners;
+	std::vector<std::string> unix_paths;
+	std::vector<std::unique_ptr<Connection>> connections;
+
+	size_t commands_count;
+};
+
+#include "Gateway-inl.h"
+
+#endif
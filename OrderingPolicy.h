@@ -0,0 +1,86 @@
+#ifndef ORDERING_POLICY_H_
+#define ORDERING_POLICY_H_
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+/**
+ * Ordering policies of PriorityQueue. A policy maps an item to a key and the item with the
+ * smallest key is on top of the queue. Policies are resolved at compile time, so a queue never
+ * pays for a virtual call and several queues with different policies can index the same items.
+ *
+ * Policies that map to an integer key let PriorityQueue sift without data dependent branches.
+ */
+/**
+ * Converts a non-negative double to an integer with the same order. Negative values come after
+ * all non-negative ones and in reverse order among themselves.
+ */
+inline uint64_t price_key(double price) noexcept
+{
+	uint64_t bits;
+	std::memcpy(&bits, &price, sizeof(bits));
+	return bits;
+}
+
+/// Orders items by their own operator<, the item that is less is on top.
+struct Natural
+{
+	template <typename Item>
+	static const Item& key(const Item& item) noexcept
+	{
+		return item;
+	}
+};
+
+/// Biggest volume on top. Item must have `volume`.
+struct MaxByVolume
+{
+	template <typename Item>
+	static uint64_t key(const Item& item) noexcept
+	{
+		return ~static_cast<uint64_t>(item.volume);
+	}
+};
+
+/// Lowest price on top. Item must have `price`.
+struct MinByPrice
+{
+	template <typename Item>
+	static uint64_t key(const Item& item) noexcept
+	{
+		return price_key(item.price);
+	}
+};
+
+/// Highest price on top. Item must have `price`.
+struct MaxByPrice
+{
+	template <typename Item>
+	static uint64_t key(const Item& item) noexcept
+	{
+		return ~price_key(item.price);
+	}
+};
+
+/// Lowest price on top, earlier order wins on equal price. Item must have `price` and `timestamp`.
+struct MinByPriceTime
+{
+	template <typename Item>
+	static std::pair<uint64_t, uint64_t> key(const Item& item) noexcept
+	{
+		return std::make_pair(price_key(item.price), static_cast<uint64_t>(item.timestamp));
+	}
+};
+
+/// Highest price on top, earlier order wins on equal price. Item must have `price` and `timestamp`.
+struct MaxByPriceTime
+{
+	template <typename Item>
+	static std::pair<uint64_t, uint64_t> key(const Item& item) noexcept
+	{
+		return std::make_pair(~price_key(item.price), static_cast<uint64_t>(item.timestamp));
+	}
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef PRICE_LADDER_INL_H_
+#define PRICE_LADDER_INL_H_
+
+#ifndef PRICE_LADDER_H_
+#error "PriceLadder-inl.h" should be included only in "PriceLadder.h" file
+#endif
+
+#include <algorithm>
+
+#include "Logger.h"
+
+using namespace std;
+
+PriceLadder::PriceLadder() noexcept
+{
+}
+
+void PriceLadder::add(uint64_t key, double price, uint32_t volume) noexcept
+{
+	const size_t index = find(key);
+
+	if (index == keys.size() || keys[index] != key)
+	{
+		PriceLevel level = {price, 0, 0};
+		keys.insert(keys.begin() + index, key);
+		levels.insert(levels.begin() + index, level);
+	}
+
+	levels[index].volume += volume;
+	++levels[index].orders;
+}
+
+void PriceLadder::remove(uint64_t key, uint32_t volume) noexcept
+{
+	const size_t index = find(key);
+
+	if (index == keys.size() || keys[index] != key)
+	{
+		Logger::warning("PriceLadder::remove(): price level not found.");
+		return;
+	}
+
+	PriceLevel& level = levels[index];
+	level.volume -= min<uint64_t>(volume, level.volume);
+	if (--level.orders == 0)
+	{
+		keys.erase(keys.begin() + index);
+		levels.erase(levels.begin() + index);
+	}
+}
+
+size_t PriceLadder::size() const noexcept
+{
+	return levels.size();
+}
+
+vector<PriceLevel> PriceLadder::get_depth(size_t count) const noexcept
+{
+	vector<PriceLevel> depth;
+	get_depth(count, depth);
+	return depth;
+}
+
+void PriceLadder::get_depth(size_t count, vector<PriceLevel>& depth) const noexcept
+{
+	count = min(count, levels.size());
+	depth.assign(levels.begin(), levels.begin() + count);
+}
+
+size_t PriceLadder::find(uint64_t key) const noexcept
+{
+	return lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+#endif
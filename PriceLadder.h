@@ -0,0 +1,52 @@
+#ifndef PRICE_LADDER_H_
+#define PRICE_LADDER_H_
+
+#include <cstdint>
+#include <vector>
+
+/// Struct that contains aggregated orders of one price
+struct PriceLevel
+{
+	double price;
+	uint64_t volume;
+	uint32_t orders;
+};
+
+/**
+ * PriceLadder keeps orders of one side aggregated per price, sorted from the best level.
+ * The caller gives every price a key in which the best price is the smallest, for example
+ * MaxByPrice for buy side and MinByPrice for sell side, see OrderingPolicy.h.
+ *
+ * Reading depth does not change the ladder, so readers may share it while no command runs.
+ * Depth is copied into a vector of the caller, which is not allocated again when it is reused.
+ */
+class PriceLadder
+{
+public:
+	inline PriceLadder() noexcept;
+
+	/// Adds an order of volume to the level of price
+	inline void add(uint64_t key, double price, uint32_t volume) noexcept;
+
+	/// Removes an order of volume from the level of price, an empty level is removed
+	inline void remove(uint64_t key, uint32_t volume) noexcept;
+
+	/// Returns number of levels
+	inline size_t size() const noexcept;
+
+	/// Returns up to `count` best levels, best first
+	inline std::vector<PriceLevel> get_depth(size_t count) const noexcept;
+
+	/// Copies up to `count` best levels into depth, best first
+	inline void get_depth(size_t count, std::vector<PriceLevel>& depth) const noexcept;
+
+private:
+	inline size_t find(uint64_t key) const noexcept;
+
+	std::vector<uint64_t> keys;
+	std::vector<PriceLevel> levels;
+};
+
+#include "PriceLadder-inl.h"
+
+#endif
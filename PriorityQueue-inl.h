@@ -6,116 +6,151 @@
 #endif
 
 #include <algorithm>
-#include <math.h>
+#include <limits>
 
 #include "Logger.h"
 
 using namespace std;
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::PriorityQueue() noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::PriorityQueue() noexcept
 : size(0)
 {
+	set_sentinel(IntegralKey());
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-void PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::insert(const QueueItem& item) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+bool PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::insert(const QueueItem& item) noexcept
 {
 	auto search = table.find(item.get_id());
 	if (search != table.end())
 	{
 		Logger::warning("PriorityQueue::insert(): item already exist.");
-		return;
+		return false;
+	}
+
+	if (size == CAPACITY)
+	{
+		Logger::error("PriorityQueue::insert(): queue is full.");
+		return false;
 	}
 
 	heap[size] = item;
+	cache_key(size, IntegralKey());
 	table[item.get_id()] = size;
-	heapify(size);
 	++size;
+	set_sentinel(IntegralKey());
+
+	sift_up(size - 1, IntegralKey());
+	return true;
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-void PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::remove(const QueueItem& item) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+bool PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::remove(const QueueItem& item) noexcept
 {
 	auto search = table.find(item.get_id());
 	if (search == table.end())
 	{
 		Logger::warning("PriorityQueue::remove(): item not found.");
-		return;
+		return false;
 	}
 
 	size_t position = search->second;
-	const QueueItem& old = heap[position];
-
-	uint32_t old_position = position;
-	uint32_t new_position = size - 1;
-
-	swap(old_position, new_position);
+	table.erase(search);
 	--size;
 
-	table.erase(search);
-	heapify(old_position);
+	if (position != size)
+	{
+		move(size, position);
+		set_sentinel(IntegralKey());
+		heapify(position);
+	}
+	else
+		set_sentinel(IntegralKey());
+
+	return true;
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-void PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::update(const QueueItem& item) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+bool PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::update(const QueueItem& item) noexcept
 {
 	auto search = table.find(item.get_id());
 	if (search == table.end())
 	{
 		Logger::warning("PriorityQueue::update(): item not found.");
-		return;
+		return false;
 	}
 
 	size_t position = search->second;
-	const QueueItem& old = heap[position];
 
 	heap[position] = item;
+	cache_key(position, IntegralKey());
 	heapify(position);
+	return true;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+const QueueItem* PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::find(const Id& id) const noexcept
+{
+	auto search = table.find(id);
+	if (search == table.end())
+		return nullptr;
+
+	return &heap[search->second];
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-size_t PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::get_orders_count() const noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+size_t PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::get_orders_count() const noexcept
 {
 	return size;
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-vector<QueueItem> PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::get_top_items(size_t k) const noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+vector<QueueItem> PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::get_top_items(size_t k) const noexcept
 {
 	k = min(k, size);
+
+	vector<QueueItem> top;
+	top.reserve(k);
 	if (k == 0)
-		return vector<QueueItem>(0);
+		return top;
 
-	size_t n = getNearestCount(k);
-	size_t start_index = pow(2, n) - 1;
-	size_t end_index = pow(2, n + 1) - 1;
+	// Candidates are sons of items already taken, the best candidate is the next top item
+	auto worse = [this](size_t a, size_t b) {
+		return is_before(b, a);
+	};
 
-	if (k == end_index)
-	{
-		vector<QueueItem> biggest(heap.begin(), heap.begin() + end_index);
-		return biggest;
-	}
-	else
+	vector<size_t> candidates;
+	candidates.reserve(k + 1);
+	candidates.push_back(0);
+
+	while (top.size() < k)
 	{
-		vector<QueueItem> biggest(heap.begin(), heap.begin() + start_index);
+		pop_heap(candidates.begin(), candidates.end(), worse);
+		const size_t position = candidates.back();
+		candidates.pop_back();
 
-		vector<QueueItem> part(heap.begin() + start_index, heap.begin() + end_index);
-		sort(part.begin(), part.end());
+		top.push_back(heap[position]);
 
-		biggest.insert(biggest.end(), part.begin(), part.begin() + k - start_index);
-		return biggest;
+		const size_t left = heap_left_son(position);
+		for (size_t son = left; son < left + 2 && son < size; son++)
+		{
+			candidates.push_back(son);
+			push_heap(candidates.begin(), candidates.end(), worse);
+		}
 	}
+
+	return top;
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
 template <typename Value, typename Match, typename Compare>
-pair<QueueItem, bool> PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::filter(const Value& value, Match match, Compare compare) const noexcept
+pair<QueueItem, bool> PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::filter(const Value& value, Match match, Compare compare) const noexcept
 {
-	QueueItem best;
+	QueueItem best = QueueItem();
 	bool is_match = false;
 
-	for (int i=0; i < size; i++)
+	for (size_t i = 0; i < size; i++)
 	{
 		if (match(heap[i], value))
 		{
@@ -128,64 +163,167 @@ pair<QueueItem, bool> PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::fil
 	return make_pair(best, is_match);
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-size_t PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::getNearestCount(size_t k) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+size_t PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::heap_parent(size_t n) noexcept
 {
-	return size_t(log(k) / log(2));
+	return (n - 1) / 2;
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-void PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::swap(size_t a, size_t b) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+size_t PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::heap_left_son(size_t n) noexcept
 {
-	QueueItem tmp = heap[a];
-	heap[a] = heap[b];
-	heap[b] = tmp;
+	return n * 2 + 1;
+}
 
-	size_t tmp_position = table[heap[a].get_id()];
-	table[heap[a].get_id()] = table[heap[a].get_id()];
-	table[heap[a].get_id()] = tmp_position; 
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+bool PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::is_before(size_t a, size_t b) const noexcept
+{
+	return is_before(a, b, IntegralKey());
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-size_t PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::heap_parent(size_t n) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+bool PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::is_before(size_t a, size_t b, std::true_type) const noexcept
 {
-	return (n - 1) / 2;
+	return keys[a] < keys[b];
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-size_t PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::heap_left_son(size_t n) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+bool PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::is_before(size_t a, size_t b, std::false_type) const noexcept
 {
-	return n * 2 + 1;
+	return Ordering::key(heap[a]) < Ordering::key(heap[b]);
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::cache_key(size_t position, std::true_type) noexcept
+{
+	keys[position] = Ordering::key(heap[position]);
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::cache_key(size_t, std::false_type) noexcept
+{
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::move_key(size_t from, size_t to, std::true_type) noexcept
+{
+	keys[to] = keys[from];
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-size_t PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::heap_right_son(size_t n) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::move_key(size_t, size_t, std::false_type) noexcept
 {
-	return n * 2 + 2;
 }
 
-template <typename QueueItem, typename Id, size_t CAPACITY, typename Less, typename Greater>
-void PriorityQueue<QueueItem, Id, CAPACITY, Less, Greater>::heapify(size_t position) noexcept
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::move(size_t from, size_t to) noexcept
 {
-	size_t i = position;
+	heap[to] = std::move(heap[from]);
+	move_key(from, to, IntegralKey());
+	table[heap[to].get_id()] = to;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::place(size_t position, QueueItem&& item) noexcept
+{
+	heap[position] = std::move(item);
+	table[heap[position].get_id()] = position;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::heapify(size_t position) noexcept
+{
+	if (position > 0 && is_before(position, heap_parent(position)))
+		sift_up(position, IntegralKey());
+	else
+		sift_down(position, IntegralKey());
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::sift_up(size_t position, std::true_type) noexcept
+{
+	// Moves parents down into the hole and puts the item once at its final position
+	QueueItem item = std::move(heap[position]);
+	const Key key = keys[position];
+
+	while (position > 0)
+	{
+		const size_t parent = heap_parent(position);
+		if (!(key < keys[parent]))
+			break;
+		move(parent, position);
+		position = parent;
+	}
+
+	keys[position] = key;
+	place(position, std::move(item));
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::sift_up(size_t position, std::false_type) noexcept
+{
+	QueueItem item = std::move(heap[position]);
+
+	while (position > 0)
+	{
+		const size_t parent = heap_parent(position);
+		if (!(Ordering::key(item) < Ordering::key(heap[parent])))
+			break;
+		move(parent, position);
+		position = parent;
+	}
+
+	place(position, std::move(item));
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::sift_down(size_t position, std::true_type) noexcept
+{
+	// keys[size] holds the biggest key, so the right son is chosen without checking its bound
+	QueueItem item = std::move(heap[position]);
+	const Key key = keys[position];
+
+	for (size_t left = heap_left_son(position); left < size; left = heap_left_son(position))
+	{
+		const size_t son = left + static_cast<size_t>(keys[left + 1] < keys[left]);
+		if (!(keys[son] < key))
+			break;
+		move(son, position);
+		position = son;
+	}
 
-	// Moves the node upwards
-	for (; i > 0 && heap[i] < heap[heap_parent(i)]; i = heap_parent(i))
-		swap(i, heap_parent(i));
+	keys[position] = key;
+	place(position, std::move(item));
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::sift_down(size_t position, std::false_type) noexcept
+{
+	QueueItem item = std::move(heap[position]);
 
-	/// Moves the node downwards
-	while (i < size && heap_left_son(i) < size)
+	for (size_t left = heap_left_son(position); left < size; left = heap_left_son(position))
 	{
-		const uint32_t left = heap_left_son(i);
-		const uint32_t right = heap_right_son(i);
-		size_t b = left;
-		if (right < size && less(heap[right], heap[left]))
-			b = right;
-		if (b >= size || !greater(heap[i], heap[b]))
+		size_t son = left;
+		if (left + 1 < size && Ordering::key(heap[left + 1]) < Ordering::key(heap[left]))
+			son = left + 1;
+		if (!(Ordering::key(heap[son]) < Ordering::key(item)))
 			break;
-		swap(i, b);
-		i = b;
+		move(son, position);
+		position = son;
 	}
+
+	place(position, std::move(item));
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::set_sentinel(std::true_type) noexcept
+{
+	keys[size] = numeric_limits<Key>::max();
+}
+
+template <typename QueueItem, typename Id, typename Ordering, size_t CAPACITY>
+void PriorityQueue<QueueItem, Id, Ordering, CAPACITY>::set_sentinel(std::false_type) noexcept
+{
 }
 
 #endif
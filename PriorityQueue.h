@@ -4,28 +4,45 @@
 #include <vector>
 #include <array>
 #include <utility>
+#include <type_traits>
 #include <unordered_map>
 
+#include "OrderingPolicy.h"
 
-template < typename QueueItem, typename Id, size_t CAPACITY = 102400, typename Less = std::less<QueueItem>, typename Greater = std::greater<QueueItem> >
+/**
+ * Indexed binary heap. The item with the smallest key of Ordering policy is on top, see
+ * OrderingPolicy.h. Integer keys are cached next to the items, so sifting never touches the
+ * items for comparison and is done without data dependent branches. Other keys are taken
+ * from the items on every comparison and are not cached.
+ */
+template < typename QueueItem, typename Id, typename Ordering = Natural, size_t CAPACITY = 102400 >
 class PriorityQueue
 {
+	typedef typename std::decay<decltype(Ordering::key(std::declval<const QueueItem&>()))>::type Key;
+
+	typedef std::integral_constant<bool, std::is_integral<Key>::value> IntegralKey;
+
+	typedef std::array<Key, IntegralKey::value ? CAPACITY + 1 : 0> KeyCache;
+
 public:
 	inline PriorityQueue() noexcept;
 
-	/// Inserts items in priority queue and index map
-	inline void insert(const QueueItem& item) noexcept;
+	/// Inserts items in priority queue and index map, returns false if id exists or queue is full
+	inline bool insert(const QueueItem& item) noexcept;
 
-	/// Removes items in priority queue and index map
-	inline void remove(const QueueItem& item) noexcept;
+	/// Removes items in priority queue and index map, returns false if id not found
+	inline bool remove(const QueueItem& item) noexcept;
 
-	/// Updates items in priority queue and index map
-	inline void update(const QueueItem& item) noexcept;
+	/// Updates items in priority queue and index map, returns false if id not found
+	inline bool update(const QueueItem& item) noexcept;
+
+	/// Returns item with id or nullptr if id not found
+	inline const QueueItem* find(const Id& id) const noexcept;
 
 	/// Returns number of item exist in data structure
 	inline size_t get_orders_count() const noexcept;
 	
-	/// Returns K top item in heap data structure
+	/// Returns K top item in heap data structure, ordered from the top
 	inline std::vector<QueueItem> get_top_items(size_t k) const noexcept;
 	
 	/// Filter data based on specific criteria
@@ -33,24 +50,47 @@ public:
 	inline std::pair<QueueItem, bool> filter(const Value& value, Match match, Compare compare) const noexcept;
 
 private:
-	inline static size_t getNearestCount(size_t k) noexcept;
-
-	inline void swap(size_t a, size_t b) noexcept;
-
 	inline static size_t heap_parent(size_t n) noexcept;
 
 	inline static size_t heap_left_son(size_t n) noexcept;
 
-	inline static size_t heap_right_son(size_t n) noexcept;
+	inline bool is_before(size_t a, size_t b) const noexcept;
+
+	inline bool is_before(size_t a, size_t b, std::true_type) const noexcept;
+
+	inline bool is_before(size_t a, size_t b, std::false_type) const noexcept;
+
+	inline void cache_key(size_t position, std::true_type) noexcept;
+
+	inline void cache_key(size_t position, std::false_type) noexcept;
+
+	inline void move_key(size_t from, size_t to, std::true_type) noexcept;
+
+	inline void move_key(size_t from, size_t to, std::false_type) noexcept;
+
+	inline void move(size_t from, size_t to) noexcept;
+
+	inline void place(size_t position, QueueItem&& item) noexcept;
 
 	inline void heapify(size_t position) noexcept;
 
+	inline void sift_up(size_t position, std::true_type) noexcept;
+
+	inline void sift_up(size_t position, std::false_type) noexcept;
+
+	inline void sift_down(size_t position, std::true_type) noexcept;
+
+	inline void sift_down(size_t position, std::false_type) noexcept;
+
+	inline void set_sentinel(std::true_type) noexcept;
+
+	inline void set_sentinel(std::false_type) noexcept;
+
 	std::unordered_map<Id, size_t> table;
 	std::array<QueueItem, CAPACITY> heap;
+	KeyCache keys;
 
 	size_t size;
-	Less less;
-	Greater greater;
 };
 
 #include "PriorityQueue-inl.h"
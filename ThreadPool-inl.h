@@ -0,0 +1,126 @@
+#ifndef THREAD_POOL_INL_H_
+#define THREAD_POOL_INL_H_
+
+#ifndef THREAD_POOL_H_
+#error "ThreadPool-inl.h" should be included only in "ThreadPool.h" file
+#endif
+
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(size_t thread_count) noexcept
+: queued(0)
+, pending(0)
+, next(0)
+, stopping(false)
+{
+	thread_count = max<size_t>(thread_count, 1);
+
+	for (size_t i = 0; i < thread_count; i++)
+		workers.emplace_back(new Worker());
+
+	for (size_t i = 0; i < thread_count; i++)
+		threads.emplace_back(&ThreadPool::run, this, i);
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+	wait();
+
+	{
+		lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (auto& thread : threads)
+		thread.join();
+}
+
+void ThreadPool::submit(Task task) noexcept
+{
+	size_t index;
+	{
+		lock_guard<std::mutex> lock(mutex);
+		index = next++ % workers.size();
+		++queued;
+		++pending;
+	}
+
+	{
+		lock_guard<std::mutex> lock(workers[index]->mutex);
+		workers[index]->tasks.push_back(std::move(task));
+	}
+
+	wake.notify_one();
+}
+
+void ThreadPool::wait() noexcept
+{
+	unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return pending == 0; });
+}
+
+size_t ThreadPool::get_thread_count() const noexcept
+{
+	return threads.size();
+}
+
+void ThreadPool::run(size_t index) noexcept
+{
+	for (;;)
+	{
+		{
+			unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || queued != 0; });
+			if (queued == 0)
+				return;
+			--queued;
+		}
+
+		// A task is reserved for this thread, it is in some deque or is about to be pushed
+		Task task;
+		while (!pop(index, task) && !steal(index, task))
+			this_thread::yield();
+
+		task();
+
+		lock_guard<std::mutex> lock(mutex);
+		if (--pending == 0)
+			done.notify_all();
+	}
+}
+
+bool ThreadPool::pop(size_t index, Task& task) noexcept
+{
+	Worker& worker = *workers[index];
+	lock_guard<std::mutex> lock(worker.mutex);
+
+	if (worker.tasks.empty())
+		return false;
+
+	task = std::move(worker.tasks.front());
+	worker.tasks.pop_front();
+	return true;
+}
+
+bool ThreadPool::steal(size_t index, Task& task) noexcept
+{
+	for (size_t i = 1; i < workers.size(); i++)
+	{
+		Worker& victim = *workers[(index + i) % workers.size()];
+		lock_guard<std::mutex> lock(victim.mutex);
+
+		if (victim.tasks.empty())
+			continue;
+
+		task = std::move(victim.tasks.front());
+		victim.tasks.pop_front();
+		return true;
+	}
+
+	return false;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef THREAD_POOL_H_
+#define THREAD_POOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Fixed size pool of threads with one task deque per thread. A thread takes its own tasks
+ * from the front of its deque and, when that is empty, steals from the front of other deques,
+ * so uneven tasks do not leave threads idle. Tasks start in the order they are submitted,
+ * which lets the caller submit the biggest tasks first.
+ */
+class ThreadPool
+{
+public:
+	typedef std::function<void()> Task;
+
+	/// Starts `thread_count` threads, at least one.
+	inline explicit ThreadPool(size_t thread_count) noexcept;
+
+	/// Waits for submitted tasks and stops threads
+	inline ~ThreadPool() noexcept;
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/// Queues a task, tasks are spread over threads in round robin
+	inline void submit(Task task) noexcept;
+
+	/// Blocks until every submitted task is finished
+	inline void wait() noexcept;
+
+	/// Returns number of threads
+	inline size_t get_thread_count() const noexcept;
+
+private:
+	/// Task deque owned by one thread
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+
+	inline void run(size_t index) noexcept;
+
+	inline bool pop(size_t index, Task& task) noexcept;
+
+	inline bool steal(size_t index, Task& task) noexcept;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable done;
+	size_t queued;
+	size_t pending;
+	size_t next;
+	bool stopping;
+};
+
+#include "ThreadPool-inl.h"
+
+#endif
@@ -0,0 +1,211 @@
+#ifndef TIERED_BOOK_INL_H_
+#define TIERED_BOOK_INL_H_
+
+#ifndef TIERED_BOOK_H_
+#error "TieredBook-inl.h" should be included only in "TieredBook.h" file
+#endif
+
+#include <algorithm>
+
+#include "Logger.h"
+
+using namespace std;
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::TieredBook() noexcept
+: window_start(0)
+, window_operations(0)
+{
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+bool TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::insert(const QueueItem& item) noexcept
+{
+	track(item.timestamp);
+
+	if (hot)
+		return hot->insert(item);
+
+	if (find_cold(item.get_id()) != cold.size())
+	{
+		Logger::warning("TieredBook::insert(): item already exist.");
+		return false;
+	}
+
+	// Equal items keep their arrival order
+	cold.insert(upper_bound(cold.begin(), cold.end(), item, is_before), item);
+
+	if (cold.size() > Tiering::PROMOTE_COUNT || window_operations > Tiering::PROMOTE_RATE)
+		promote();
+
+	return true;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+bool TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::remove(const QueueItem& item) noexcept
+{
+	track(item.timestamp);
+
+	if (hot)
+		return hot->remove(item);
+
+	const size_t position = find_cold(item.get_id());
+	if (position == cold.size())
+	{
+		Logger::warning("TieredBook::remove(): item not found.");
+		return false;
+	}
+
+	cold.erase(cold.begin() + position);
+	return true;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+bool TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::update(const QueueItem& item) noexcept
+{
+	track(item.timestamp);
+
+	if (hot)
+		return hot->update(item);
+
+	const size_t position = find_cold(item.get_id());
+	if (position == cold.size())
+	{
+		Logger::warning("TieredBook::update(): item not found.");
+		return false;
+	}
+
+	cold.erase(cold.begin() + position);
+	cold.insert(upper_bound(cold.begin(), cold.end(), item, is_before), item);
+
+	if (window_operations > Tiering::PROMOTE_RATE)
+		promote();
+
+	return true;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+const QueueItem* TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::find(const Id& id) const noexcept
+{
+	if (hot)
+		return hot->find(id);
+
+	const size_t position = find_cold(id);
+	return position == cold.size() ? nullptr : &cold[position];
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+size_t TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::get_orders_count() const noexcept
+{
+	return hot ? hot->get_orders_count() : cold.size();
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+vector<QueueItem> TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::get_top_items(size_t k) const noexcept
+{
+	if (hot)
+		return hot->get_top_items(k);
+
+	return vector<QueueItem>(cold.begin(), cold.begin() + min(k, cold.size()));
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+template <typename Value, typename Match, typename Compare>
+pair<QueueItem, bool> TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::filter(const Value& value, Match match, Compare compare) const noexcept
+{
+	if (hot)
+		return hot->filter(value, match, compare);
+
+	QueueItem best = QueueItem();
+	bool is_match = false;
+
+	for (auto& item : cold)
+	{
+		if (match(item, value))
+		{
+			is_match = true;
+			if (compare(best, item))
+				best = item;
+		}
+	}
+
+	return make_pair(best, is_match);
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+bool TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::is_hot() const noexcept
+{
+	return static_cast<bool>(hot);
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+size_t TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::get_memory_usage() const noexcept
+{
+	// A node of the index map holds the pair, a next pointer and the cached hash
+	static constexpr size_t INDEX_NODE_SIZE = sizeof(pair<const Id, size_t>) + 2 * sizeof(void*);
+
+	size_t usage = sizeof(*this) + cold.capacity() * sizeof(QueueItem);
+	if (hot)
+		usage += sizeof(HotBook) + hot->get_orders_count() * (INDEX_NODE_SIZE + sizeof(void*));
+
+	return usage;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+void TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::compact(uint64_t time) noexcept
+{
+	// A hot book is demoted when a quiet window ends, a rollover starts a new window
+	const bool is_over = time < window_start ? window_start - time > Tiering::ROLLOVER
+		: time - window_start >= Tiering::RATE_WINDOW;
+
+	if (is_over)
+	{
+		if (hot && hot->get_orders_count() < Tiering::DEMOTE_COUNT && window_operations < Tiering::DEMOTE_RATE)
+			demote();
+
+		window_start = time;
+		window_operations = 0;
+	}
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+void TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::track(uint64_t time) noexcept
+{
+	compact(time);
+	++window_operations;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+void TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::promote() noexcept
+{
+	hot.reset(new HotBook());
+	for (auto& item : cold)
+		hot->insert(item);
+
+	vector<QueueItem>().swap(cold);
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+void TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::demote() noexcept
+{
+	cold = hot->get_top_items(hot->get_orders_count());
+	hot.reset();
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+size_t TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::find_cold(const Id& id) const noexcept
+{
+	size_t position = 0;
+	while (position < cold.size() && !(cold[position].get_id() == id))
+		++position;
+
+	return position;
+}
+
+template <typename QueueItem, typename Id, typename Ordering, typename Tiering, size_t CAPACITY>
+bool TieredBook<QueueItem, Id, Ordering, Tiering, CAPACITY>::is_before(const QueueItem& a, const QueueItem& b) noexcept
+{
+	return Ordering::key(a) < Ordering::key(b);
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef TIERED_BOOK_H_
+#define TIERED_BOOK_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "PriorityQueue.h"
+
+/**
+ * Thresholds of TieredBook. A cold book is promoted when it holds more than PROMOTE_COUNT
+ * items or sees more than PROMOTE_RATE operations in one RATE_WINDOW (microseconds of item
+ * timestamps). A hot book is demoted at the end of a window with fewer than DEMOTE_COUNT items
+ * and fewer than DEMOTE_RATE operations. The gap between both pairs stops a book from flapping.
+ * Time going back by more than ROLLOVER, for example after midnight, also ends the window.
+ * Smaller steps back come from clients with skewed clocks and count in the current window.
+ */
+struct DefaultTiering
+{
+	static constexpr size_t PROMOTE_COUNT = 64;
+	static constexpr size_t DEMOTE_COUNT = 16;
+	static constexpr size_t PROMOTE_RATE = 512;
+	static constexpr size_t DEMOTE_RATE = 64;
+	static constexpr uint64_t RATE_WINDOW = 1000000;
+	static constexpr uint64_t ROLLOVER = 12ULL * 3600 * 1000000;
+};
+
+/// Tiering that keeps every book in the indexed heap
+struct AlwaysHot
+{
+	static constexpr size_t PROMOTE_COUNT = 0;
+	static constexpr size_t DEMOTE_COUNT = 0;
+	static constexpr size_t PROMOTE_RATE = 0;
+	static constexpr size_t DEMOTE_RATE = 0;
+	static constexpr uint64_t RATE_WINDOW = UINT64_MAX;
+	static constexpr uint64_t ROLLOVER = UINT64_MAX;
+};
+
+/**
+ * TieredBook has the interface of PriorityQueue but keeps few items in a small vector sorted
+ * in place, best first. Only a busy book pays for the indexed heap with its fixed array and
+ * index map. Items must have `timestamp`, which measures the rate of operations.
+ */
+template < typename QueueItem, typename Id, typename Ordering = Natural, typename Tiering = DefaultTiering, size_t CAPACITY = 102400 >
+class TieredBook
+{
+	typedef PriorityQueue<QueueItem, Id, Ordering, CAPACITY> HotBook;
+
+public:
+	inline TieredBook() noexcept;
+
+	/// Inserts item, returns false if id exists or book is full
+	inline bool insert(const QueueItem& item) noexcept;
+
+	/// Removes item, returns false if id not found
+	inline bool remove(const QueueItem& item) noexcept;
+
+	/// Updates item, returns false if id not found
+	inline bool update(const QueueItem& item) noexcept;
+
+	/// Returns item with id or nullptr if id not found
+	inline const QueueItem* find(const Id& id) const noexcept;
+
+	/// Returns number of item exist in data structure
+	inline size_t get_orders_count() const noexcept;
+
+	/// Returns K top item, ordered from the top
+	inline std::vector<QueueItem> get_top_items(size_t k) const noexcept;
+
+	/// Filter data based on specific criteria
+	template <typename Value, typename Match, typename Compare>
+	inline std::pair<QueueItem, bool> filter(const Value& value, Match match, Compare compare) const noexcept;
+
+	/// Returns true if items are in the indexed heap
+	inline bool is_hot() const noexcept;
+
+	/// Returns bytes used by the book, approximately
+	inline size_t get_memory_usage() const noexcept;
+
+	/// Ends the window if it is over at time, so a hot book without operations is demoted too
+	inline void compact(uint64_t time) noexcept;
+
+private:
+	inline void track(uint64_t time) noexcept;
+
+	inline void promote() noexcept;
+
+	inline void demote() noexcept;
+
+	inline size_t find_cold(const Id& id) const noexcept;
+
+	inline static bool is_before(const QueueItem& a, const QueueItem& b) noexcept;
+
+	std::vector<QueueItem> cold;
+	std::unique_ptr<HotBook> hot;
+
+	uint64_t window_start;
+	size_t window_operations;
+};
+
+#include "TieredBook-inl.h"
+
+#endif
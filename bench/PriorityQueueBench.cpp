@@ -0,0 +1,99 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../PriorityQueue.h"
+
+using namespace std;
+
+/// Same layout as the order stored by DBManager
+struct Order
+{
+	uint32_t id;
+	std::string time;
+	uint64_t timestamp;
+	uint32_t volume;
+	double price;
+
+	uint32_t get_id() const noexcept
+	{
+		return id;
+	}
+
+	bool operator<(const Order& p) const noexcept
+	{
+		return volume > p.volume;
+	}
+};
+
+static constexpr size_t ORDER_COUNT = 50000;
+static constexpr size_t ROUNDS = 10;
+
+vector<Order> make_orders()
+{
+	mt19937 generator(42);
+	uniform_int_distribution<uint32_t> volume(1, 1000);
+	uniform_int_distribution<uint32_t> ticks(2000, 4000);
+
+	vector<Order> orders(ORDER_COUNT);
+	for (size_t i = 0; i < ORDER_COUNT; i++)
+	{
+		orders[i].id = i;
+		orders[i].time = "09:00:00.000000";
+		orders[i].timestamp = i;
+		orders[i].volume = volume(generator);
+		orders[i].price = ticks(generator) / 100.0;
+	}
+
+	return orders;
+}
+
+template <typename Ordering>
+void run(const string& name, const vector<Order>& orders)
+{
+	typedef PriorityQueue<Order, uint32_t, Ordering> Queue;
+
+	vector<Order> amended(orders);
+	for (auto& order : amended)
+	{
+		order.volume = order.volume * 7 % 1000 + 1;
+		order.price += 0.05;
+	}
+
+	chrono::nanoseconds elapsed(0);
+	size_t checksum = 0;
+
+	for (size_t round = 0; round < ROUNDS; round++)
+	{
+		unique_ptr<Queue> queue(new Queue());
+
+		auto start = chrono::steady_clock::now();
+		for (auto& order : orders)
+			queue->insert(order);
+		for (auto& order : amended)
+			queue->update(order);
+		for (size_t i = 0; i < 1000; i++)
+			checksum += queue->get_top_items(3).size();
+		for (auto& order : orders)
+			queue->remove(order);
+		elapsed += chrono::steady_clock::now() - start;
+	}
+
+	const double operations = ROUNDS * (3.0 * orders.size() + 1000);
+	cout << name << "\t" << elapsed.count() / operations << " ns/op\t(" << checksum << ")" << endl;
+}
+
+int main()
+{
+	const vector<Order> orders = make_orders();
+
+	run<Natural>("Natural", orders);
+	run<MaxByVolume>("MaxByVolume", orders);
+	run<MinByPrice>("MinByPrice", orders);
+	run<MaxByPrice>("MaxByPrice", orders);
+	run<MinByPriceTime>("MinByPriceTime", orders);
+	run<MaxByPriceTime>("MaxByPriceTime", orders);
+}
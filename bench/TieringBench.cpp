@@ -0,0 +1,245 @@
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "../DBManager.h"
+#include "../TieredBook.h"
+
+using namespace std;
+
+/// Same layout as the order stored by DBManager
+struct Order
+{
+	uint32_t id;
+	std::string time;
+	uint64_t timestamp;
+	uint32_t volume;
+	double price;
+
+	uint32_t get_id() const noexcept
+	{
+		return id;
+	}
+};
+
+/// One command of the synthetic feed
+struct Event
+{
+	uint32_t book;
+	char instruction;
+	Order order;
+};
+
+static constexpr size_t EVENT_COUNT = 2000000;
+static constexpr double ZIPF_EXPONENT = 1.1;
+static constexpr uint64_t TRADING_DAY = 23400ULL * 1000000;
+static constexpr uint64_t DAY = 86400ULL * 1000000;
+static constexpr uint64_t MARKET_OPEN = 9ULL * 3600 * 1000000;
+static constexpr uint64_t CLOCK_SKEW = 2000000;
+
+/// Symbols are drawn with Zipf distribution, every symbol has a buy and a sell book
+vector<Event> make_feed(size_t symbols)
+{
+	mt19937 generator(42);
+
+	vector<double> weights(symbols);
+	for (size_t i = 0; i < symbols; i++)
+		weights[i] = 1.0 / pow(i + 1, ZIPF_EXPONENT);
+
+	discrete_distribution<uint32_t> symbol(weights.begin(), weights.end());
+	uniform_int_distribution<uint32_t> side(0, 1);
+	uniform_int_distribution<uint32_t> action(0, 99);
+	uniform_int_distribution<uint32_t> volume(1, 1000);
+	uniform_int_distribution<uint32_t> ticks(2000, 4000);
+
+	vector<vector<uint32_t>> live(symbols * 2);
+	vector<Event> feed(EVENT_COUNT);
+	uint32_t next_id = 0;
+
+	for (size_t i = 0; i < EVENT_COUNT; i++)
+	{
+		Event& event = feed[i];
+		event.book = symbol(generator) * 2 + side(generator);
+		event.order.time = "09:00:00.000000";
+		event.order.timestamp = i * TRADING_DAY / EVENT_COUNT;
+		event.order.volume = volume(generator);
+		event.order.price = ticks(generator) / 100.0;
+
+		vector<uint32_t>& orders = live[event.book];
+		const uint32_t roll = action(generator);
+
+		// Inserts and cancels balance, so books stay about as deep as in a real day
+		if (orders.empty() || roll < 45)
+		{
+			event.instruction = 'I';
+			event.order.id = next_id++;
+			orders.push_back(event.order.id);
+			continue;
+		}
+
+		const size_t index = uniform_int_distribution<size_t>(0, orders.size() - 1)(generator);
+		event.order.id = orders[index];
+
+		if (roll < 90)
+		{
+			event.instruction = 'C';
+			orders[index] = orders.back();
+			orders.pop_back();
+		}
+		else
+			event.instruction = 'A';
+	}
+
+	return feed;
+}
+
+size_t resident_bytes()
+{
+	size_t pages = 0;
+	size_t resident = 0;
+	ifstream("/proc/self/statm") >> pages >> resident;
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+/// Runs the feed in a child process, so resident memory of one run does not leak into the next
+template <typename Book>
+void run(const string& name, const vector<Event>& feed)
+{
+	cout.flush();
+	const pid_t child = fork();
+	if (child != 0)
+	{
+		waitpid(child, nullptr, 0);
+		return;
+	}
+
+	const size_t before = resident_bytes();
+
+	unordered_map<uint32_t, Book> books;
+	auto start = chrono::steady_clock::now();
+	for (auto& event : feed)
+	{
+		Book& book = books[event.book];
+		if (event.instruction == 'I')
+			book.insert(event.order);
+		else if (event.instruction == 'C')
+			book.remove(event.order);
+		else
+			book.update(event.order);
+	}
+	const chrono::nanoseconds elapsed = chrono::steady_clock::now() - start;
+
+	cout << name << "\tbooks " << books.size() << "\t" << elapsed.count() / double(feed.size()) << " ns/event\t"
+		<< (resident_bytes() - before) / (1024.0 * 1024.0) << " MiB resident" << endl;
+	_exit(0);
+}
+
+template <typename Book>
+void report_tiers(const vector<Event>& feed, size_t symbols)
+{
+	unordered_map<uint32_t, Book> books;
+	for (auto& event : feed)
+	{
+		Book& book = books[event.book];
+		if (event.instruction == 'I')
+			book.insert(event.order);
+		else if (event.instruction == 'C')
+			book.remove(event.order);
+		else
+			book.update(event.order);
+	}
+
+	size_t hot = 0;
+	size_t usage = 0;
+	for (auto& element : books)
+	{
+		hot += element.second.is_hot();
+		usage += element.second.get_memory_usage();
+	}
+
+	typedef PriorityQueue<Order, uint32_t, MaxByVolume> HotBook;
+	cout << symbols << " symbols: " << books.size() << " books, " << hot << " hot at end of day, books use "
+		<< usage / (1024.0 * 1024.0) << " MiB, all hot would use at least "
+		<< books.size() * sizeof(HotBook) / (1024.0 * 1024.0) << " MiB" << endl;
+}
+
+/// Formats feed as command lines, `skew` is added to every second event and time wraps at midnight
+string make_commands(const vector<Event>& feed, uint64_t open, uint64_t skew)
+{
+	string commands;
+	char line[128];
+	for (size_t i = 0; i < feed.size(); i++)
+	{
+		const Event& event = feed[i];
+		const uint64_t time = (open + event.order.timestamp + (i % 2 == 1 ? skew : 0)) % DAY;
+		const int size = snprintf(line, sizeof(line), "%02llu:%02llu:%02llu.%06llu;S%u;%u;%c;%s;%u;%.2f\n",
+			static_cast<unsigned long long>(time / 3600000000ULL), static_cast<unsigned long long>(time / 60000000 % 60),
+			static_cast<unsigned long long>(time / 1000000 % 60), static_cast<unsigned long long>(time % 1000000),
+			event.book / 2, event.order.id, event.instruction, event.book % 2 == 0 ? "BUY" : "SELL",
+			event.order.volume, event.order.price);
+		commands.append(line, size);
+	}
+
+	return commands;
+}
+
+/// Runs command lines through DBManager in a child process, with ladders, bars and sweeps of hot books
+void run_manager(const string& name, const string& commands, size_t count)
+{
+	cout.flush();
+	const pid_t child = fork();
+	if (child != 0)
+	{
+		waitpid(child, nullptr, 0);
+		return;
+	}
+
+	const size_t before = resident_bytes();
+
+	unique_ptr<DBManager> manager(new DBManager());
+	auto start = chrono::steady_clock::now();
+	for (size_t position = 0; position < commands.size();)
+	{
+		const size_t end = commands.find('\n', position);
+		manager->execute_command(commands.data() + position, end - position);
+		position = end + 1;
+	}
+	const chrono::nanoseconds elapsed = chrono::steady_clock::now() - start;
+
+	cout << name << "\t" << elapsed.count() / double(count) << " ns/event\t"
+		<< (resident_bytes() - before) / (1024.0 * 1024.0) << " MiB resident" << endl;
+	_exit(0);
+}
+
+int main()
+{
+	// All hot books are only affordable for a small universe
+	const size_t small_universe = 100;
+	const vector<Event> small_feed = make_feed(small_universe);
+
+	cout << "Zipf feed of " << EVENT_COUNT << " events over " << small_universe << " symbols" << endl;
+	run<TieredBook<Order, uint32_t, MaxByVolume>>("tiered", small_feed);
+	run<TieredBook<Order, uint32_t, MaxByVolume, AlwaysHot>>("always hot", small_feed);
+	run<PriorityQueue<Order, uint32_t, MaxByVolume>>("heap only", small_feed);
+
+	const size_t large_universe = 20000;
+	const vector<Event> large_feed = make_feed(large_universe);
+
+	cout << "Zipf feed of " << EVENT_COUNT << " events over " << large_universe << " symbols" << endl;
+	run<TieredBook<Order, uint32_t, MaxByVolume>>("tiered", large_feed);
+	report_tiers<TieredBook<Order, uint32_t, MaxByVolume>>(large_feed, large_universe);
+
+	// Same feed through DBManager, time of the last feed runs from 20:00 over midnight
+	cout << "DBManager, same feed over " << large_universe << " symbols" << endl;
+	run_manager("monotonic", make_commands(large_feed, MARKET_OPEN, 0), large_feed.size());
+	run_manager("skewed clients", make_commands(large_feed, MARKET_OPEN, CLOCK_SKEW), large_feed.size());
+	run_manager("over midnight", make_commands(large_feed, 20ULL * 3600 * 1000000, CLOCK_SKEW), large_feed.size());
+}
@@ -0,0 +1,65 @@
+#include <csignal>
+#include <iostream>
+#include <string>
+
+#include "Gateway.h"
+
+using namespace std;
+
+static Gateway* running_gateway = nullptr;
+
+void handle_signal(int)
+{
+	if (running_gateway)
+		running_gateway->stop();
+}
+
+int main(int argc, char **argv)
+{
+	string unix_path;
+	int port = -1;
+
+	for (int i = 1; i + 1 < argc; i += 2)
+	{
+		const string argument = argv[i];
+		if (argument == "-u")
+			unix_path = argv[i + 1];
+		else if (argument == "-p")
+			port = stoi(argv[i + 1]);
+	}
+
+	if (unix_path.empty() && port < 0)
+	{
+		cout << "Usage: gateway [-u unix-socket-path] [-p loopback-tcp-port]" << endl;
+		return 0;
+	}
+
+	Logger::init("gateway");
+
+	DBManager manager;
+	Gateway gateway(manager);
+
+	if (!unix_path.empty() && !gateway.listen_unix(unix_path))
+	{
+		cout << "Can not listen on " << unix_path << endl;
+		return 1;
+	}
+
+	if (port >= 0 && !gateway.listen_tcp(port))
+	{
+		cout << "Can not listen on port " << port << endl;
+		return 1;
+	}
+
+	running_gateway = &gateway;
+	signal(SIGINT, handle_signal);
+	signal(SIGTERM, handle_signal);
+
+	gateway.run();
+
+	cout << "Executed " << gateway.get_commands_count() << " commands" << endl;
+	unordered_map<string, size_t> orders_count = manager.get_orders_count();
+	cout << "Orders count : " << endl;
+	for (auto& element : orders_count)
+		cout << element.first << "\t" << element.second << endl;
+}
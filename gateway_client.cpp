@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+int connect_unix(const string& path)
+{
+	sockaddr_un address = {};
+	if (path.size() >= sizeof(address.sun_path))
+		return -1;
+
+	address.sun_family = AF_UNIX;
+	memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	return fd;
+}
+
+int connect_tcp(int port)
+{
+	sockaddr_in address = {};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	int fd = socket(AF_INET, SOCK_STREAM, 0);
+	if (fd >= 0 && connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		close(fd);
+		return -1;
+	}
+
+	int no_delay = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+	return fd;
+}
+
+bool write_all(int fd, const char* data, size_t size)
+{
+	while (size != 0)
+	{
+		const ssize_t written = write(fd, data, size);
+		if (written <= 0)
+			return false;
+		data += written;
+		size -= written;
+	}
+
+	return true;
+}
+
+double percentile(const vector<uint64_t>& sorted, double rank)
+{
+	if (sorted.empty())
+		return 0;
+
+	const size_t index = min(sorted.size() - 1, static_cast<size_t>(rank * sorted.size()));
+	return sorted[index] / 1000.0;
+}
+
+int main(int argc, char **argv)
+{
+	string unix_path;
+	int port = -1;
+	size_t count = 0;
+	size_t window = 1;
+	string file = "orders.dat";
+
+	for (int i = 1; i < argc; i++)
+	{
+		const string argument = argv[i];
+		if (argument == "-u" && i + 1 < argc)
+			unix_path = argv[++i];
+		else if (argument == "-p" && i + 1 < argc)
+			port = stoi(argv[++i]);
+		else if (argument == "-n" && i + 1 < argc)
+			count = stoul(argv[++i]);
+		else if (argument == "-w" && i + 1 < argc)
+			window = max(stoul(argv[++i]), 1ul);
+		else
+			file = argument;
+	}
+
+	if (unix_path.empty() && port < 0)
+	{
+		cout << "Usage: gateway_client (-u unix-socket-path | -p loopback-tcp-port) [-n count] [-w window] [orders file]" << endl;
+		return 0;
+	}
+
+	vector<string> orders;
+	ifstream infile(file);
+	for (string order; getline(infile, order); )
+		if (!order.empty())
+			orders.push_back(order + "\n");
+
+	if (orders.empty())
+	{
+		cout << "No orders in " << file << endl;
+		return 1;
+	}
+
+	if (count == 0)
+		count = orders.size();
+
+	const int fd = unix_path.empty() ? connect_tcp(port) : connect_unix(unix_path);
+	if (fd < 0)
+	{
+		cout << "Can not connect to gateway" << endl;
+		return 1;
+	}
+
+	vector<Clock::time_point> sent_at(window);
+	vector<uint64_t> latencies;
+	latencies.reserve(count);
+
+	string batch;
+	char answers[4096];
+	size_t sent = 0;
+	size_t received = 0;
+	size_t errors = 0;
+
+	auto start = Clock::now();
+	while (received < count)
+	{
+		// Fills the window with one write
+		batch.clear();
+		const Clock::time_point now = Clock::now();
+		for (; sent < count && sent - received < window; sent++)
+		{
+			batch += orders[sent % orders.size()];
+			sent_at[sent % window] = now;
+		}
+
+		if (!batch.empty() && !write_all(fd, batch.data(), batch.size()))
+		{
+			cout << "Connection closed while sending" << endl;
+			return 1;
+		}
+
+		const ssize_t size = read(fd, answers, sizeof(answers));
+		if (size <= 0)
+		{
+			cout << "Connection closed while receiving" << endl;
+			return 1;
+		}
+
+		const Clock::time_point arrived = Clock::now();
+		for (ssize_t i = 0; i < size; i++)
+		{
+			if (answers[i] == 'E')
+				++errors;
+			if (answers[i] != '\n')
+				continue;
+
+			latencies.push_back(chrono::duration_cast<chrono::nanoseconds>(arrived - sent_at[received % window]).count());
+			++received;
+		}
+	}
+	const double seconds = chrono::duration<double>(Clock::now() - start).count();
+
+	close(fd);
+	sort(latencies.begin(), latencies.end());
+
+	cout << "Commands : " << received << ", errors : " << errors << ", window : " << window << endl;
+	cout << "Throughput : " << received / seconds << " commands/s" << endl;
+	cout << "Round trip (us) : p50 " << percentile(latencies, 0.5) << ", p90 " << percentile(latencies, 0.9)
+		<< ", p99 " << percentile(latencies, 0.99) << ", p99.9 " << percentile(latencies, 0.999)
+		<< ", max " << latencies.back() / 1000.0 << endl;
+}
@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DBManager.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+static constexpr size_t TOP_ORDERS = 10;
+static constexpr size_t DEPTH_LEVELS = 10;
+
+static const char* const QUERY_TIMES[] = {"09:30:00", "10:30:00", "11:30:00", "12:30:00", "13:30:00", "14:30:00", "15:30:00", "16:30:00"};
+
+/// Result of replaying a feed
+struct Measure
+{
+	string digest;
+	double events_per_second;
+	double p50_ns;
+	double p99_ns;
+	double p999_ns;
+};
+
+void print_usage()
+{
+	cout << "Usage: harness [--record] [-b baseline] [-t threshold] [-l latency-threshold] [-r repeat] [-d dump] <feed>" << endl;
+}
+
+/// Writes final book and query results with symbols sorted and fixed number format
+void write_canonical(ostream& out, const DBManager& manager)
+{
+	const unordered_map<string, size_t> orders_count = manager.get_orders_count();
+	const map<string, size_t> sorted(orders_count.begin(), orders_count.end());
+
+	char number[64];
+	auto format = [&number](double value) {
+		snprintf(number, sizeof(number), "%.6f", value);
+		return number;
+	};
+
+	DBManager::Depth depth;
+	for (auto& element : sorted)
+	{
+		const string& symbol = element.first;
+		out << symbol << " orders " << element.second << "\n";
+
+		out << symbol << " biggest_buy";
+		for (auto volume : manager.get_biggest_buy_order(symbol, TOP_ORDERS))
+			out << " " << volume;
+		out << "\n";
+
+		for (auto time : QUERY_TIMES)
+		{
+			size_t price;
+			size_t volume;
+			bool is_valid;
+			std::tie(price, volume, is_valid) = manager.get_best_sell_at_time(symbol, time);
+			out << symbol << " best_sell " << time << " " << is_valid << " " << price << " " << volume << "\n";
+		}
+
+		manager.get_depth(symbol, DEPTH_LEVELS, depth);
+		for (auto& level : depth.bids)
+			out << symbol << " bid " << format(level.price) << " " << level.volume << " " << level.orders << "\n";
+		for (auto& level : depth.asks)
+			out << symbol << " ask " << format(level.price) << " " << level.volume << " " << level.orders << "\n";
+
+		for (auto& bar : manager.get_bars(symbol))
+		{
+			out << symbol << " bar " << bar.start_time << " " << format(bar.open) << " " << format(bar.high) << " "
+				<< format(bar.low) << " " << format(bar.close) << " " << bar.volume << " " << format(bar.vwap()) << " "
+				<< bar.inserts << " " << bar.cancels << " " << bar.amends << "\n";
+		}
+	}
+}
+
+/// FNV-1a 64 bit hash in hex
+string digest(const string& text)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	for (unsigned char c : text)
+	{
+		hash ^= c;
+		hash *= 1099511628211ULL;
+	}
+
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+	return hex;
+}
+
+double percentile(const vector<uint32_t>& sorted, double rank)
+{
+	const size_t index = min(sorted.size() - 1, static_cast<size_t>(rank * sorted.size()));
+	return sorted[index];
+}
+
+Measure measure(const vector<string>& feed, size_t repeat, const string& dump)
+{
+	// Every number is the best of all runs, which is far less noisy than a single run
+	Measure result = {"", 0, 1e18, 1e18, 1e18};
+	vector<uint32_t> latencies(feed.size());
+
+	for (size_t run = 0; run < repeat; run++)
+	{
+		unique_ptr<DBManager> manager(new DBManager());
+
+		const Clock::time_point start = Clock::now();
+		Clock::time_point before = start;
+		for (size_t i = 0; i < feed.size(); i++)
+		{
+			manager->execute_command(feed[i]);
+			const Clock::time_point after = Clock::now();
+			latencies[i] = chrono::duration_cast<chrono::nanoseconds>(after - before).count();
+			before = after;
+		}
+
+		sort(latencies.begin(), latencies.end());
+		result.events_per_second = max(result.events_per_second, feed.size() / chrono::duration<double>(before - start).count());
+		result.p50_ns = min(result.p50_ns, percentile(latencies, 0.5));
+		result.p99_ns = min(result.p99_ns, percentile(latencies, 0.99));
+		result.p999_ns = min(result.p999_ns, percentile(latencies, 0.999));
+
+		ostringstream canonical;
+		write_canonical(canonical, *manager);
+		const string run_digest = digest(canonical.str());
+
+		if (run == 0)
+		{
+			result.digest = run_digest;
+			if (!dump.empty())
+				ofstream(dump) << canonical.str();
+		}
+		else if (run_digest != result.digest)
+			result.digest = "nondeterministic";
+	}
+
+	return result;
+}
+
+bool read_baseline(const string& file, Measure& baseline)
+{
+	ifstream infile(file);
+	if (!infile.is_open())
+		return false;
+
+	map<string, string> values;
+	for (string line; getline(infile, line); )
+	{
+		const size_t position = line.find('=');
+		if (position != string::npos)
+			values[line.substr(0, position)] = line.substr(position + 1);
+	}
+
+	if (!values.count("digest") || !values.count("events_per_second") || !values.count("p50_ns") ||
+		!values.count("p99_ns") || !values.count("p999_ns"))
+		return false;
+
+	baseline.digest = values["digest"];
+	baseline.events_per_second = stod(values["events_per_second"]);
+	baseline.p50_ns = stod(values["p50_ns"]);
+	baseline.p99_ns = stod(values["p99_ns"]);
+	baseline.p999_ns = stod(values["p999_ns"]);
+	return true;
+}
+
+void write_measure(ostream& out, const Measure& measure)
+{
+	out << "digest=" << measure.digest << "\n";
+	out << "events_per_second=" << static_cast<uint64_t>(measure.events_per_second) << "\n";
+	out << "p50_ns=" << measure.p50_ns << "\n";
+	out << "p99_ns=" << measure.p99_ns << "\n";
+	out << "p999_ns=" << measure.p999_ns << "\n";
+}
+
+/// Returns false if value is worse than baseline by more than threshold
+bool check(const string& name, double value, double baseline, double threshold, bool higher_is_better)
+{
+	const double change = (value - baseline) / baseline;
+	const bool is_regressed = higher_is_better ? change < -threshold : change > threshold;
+
+	cout << (is_regressed ? "FAIL " : "ok   ") << name << " " << value << " (baseline " << baseline << ", "
+		<< (change >= 0 ? "+" : "") << change * 100 << "%)" << endl;
+	return !is_regressed;
+}
+
+int main(int argc, char **argv)
+{
+	bool is_record = false;
+	string baseline_file = "bench/baseline.txt";
+	string dump;
+	double threshold = 0.25;
+	double latency_threshold = 0.5;
+	size_t repeat = 10;
+	string feed_file;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const string argument = argv[i];
+		if (argument == "--record")
+			is_record = true;
+		else if (argument == "-b" && i + 1 < argc)
+			baseline_file = argv[++i];
+		else if (argument == "-t" && i + 1 < argc)
+			threshold = stod(argv[++i]);
+		else if (argument == "-l" && i + 1 < argc)
+			latency_threshold = stod(argv[++i]);
+		else if (argument == "-r" && i + 1 < argc)
+			repeat = max(stoul(argv[++i]), 1ul);
+		else if (argument == "-d" && i + 1 < argc)
+			dump = argv[++i];
+		else
+			feed_file = argument;
+	}
+
+	if (feed_file.empty())
+	{
+		print_usage();
+		return 0;
+	}
+
+	vector<string> feed;
+	ifstream infile(feed_file);
+	for (string command; getline(infile, command); )
+		if (!command.empty())
+			feed.push_back(command);
+
+	if (feed.empty())
+	{
+		cout << "No commands in " << feed_file << endl;
+		return 1;
+	}
+
+	const Measure result = measure(feed, repeat, dump);
+	write_measure(cout, result);
+
+	if (is_record)
+	{
+		ofstream outfile(baseline_file);
+		write_measure(outfile, result);
+		cout << "Baseline written to " << baseline_file << endl;
+		return 0;
+	}
+
+	Measure baseline;
+	if (!read_baseline(baseline_file, baseline))
+	{
+		cout << "Can not read baseline " << baseline_file << ", record one with --record" << endl;
+		return 1;
+	}
+
+	bool is_passed = true;
+	if (result.digest != baseline.digest)
+	{
+		cout << "FAIL digest " << result.digest << " (baseline " << baseline.digest << ")" << endl;
+		is_passed = false;
+	}
+	else
+		cout << "ok   digest " << result.digest << endl;
+
+	is_passed &= check("events_per_second", result.events_per_second, baseline.events_per_second, threshold, true);
+	// Single command latency is short enough that timer and scheduler noise needs a wider margin
+	is_passed &= check("p50_ns", result.p50_ns, baseline.p50_ns, latency_threshold, false);
+	is_passed &= check("p99_ns", result.p99_ns, baseline.p99_ns, latency_threshold, false);
+
+	cout << (is_passed ? "PASSED" : "FAILED") << endl;
+	return is_passed ? 0 : 1;
+}
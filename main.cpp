@@ -52,4 +52,26 @@ int main(int argc, char **argv)
 		cout << "Best sell price at time 15:30:00 for symbol DVAM1 is {" << price << "} and its volume is {" << volume << endl;
 	else
 		cout << "Best sell price at time 15:30:00 for symbol DVAM1 Not found" << endl;
+
+	DBManager::Depth depth = manager.get_depth("DVAM1", 5);
+	cout << "Depth for symbol \"DVAM1\" : " << endl;
+	cout << "bid volume\tbid price\task price\task volume" << endl;
+	for (size_t i = 0; i < max(depth.bids.size(), depth.asks.size()); i++)
+	{
+		if (i < depth.bids.size())
+			cout << depth.bids[i].volume << "\t" << depth.bids[i].price;
+		else
+			cout << "\t";
+		cout << "\t";
+		if (i < depth.asks.size())
+			cout << depth.asks[i].price << "\t" << depth.asks[i].volume;
+		cout << endl;
+	}
+
+	vector<Bar> bars = manager.get_bars("DVAM1", 5);
+	cout << "Last bars for symbol \"DVAM1\" : " << endl;
+	cout << "start\topen\thigh\tlow\tclose\tvolume\tvwap\tI/C/A" << endl;
+	for (auto& bar : bars)
+		cout << bar.start_time << "\t" << bar.open << "\t" << bar.high << "\t" << bar.low << "\t" << bar.close << "\t"
+			<< bar.volume << "\t" << bar.vwap() << "\t" << bar.inserts << "/" << bar.cancels << "/" << bar.amends << endl;
 }
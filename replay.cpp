@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glob.h>
+#include <sys/stat.h>
+
+#include "DBManager.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/// Result of replaying one daily file
+struct DayResult
+{
+	string file;
+	bool is_open;
+	size_t events;
+	size_t rejected;
+	double seconds;
+	map<string, size_t> orders_count;
+	map<string, array<uint64_t, 4>> activity;
+};
+
+/// Indexes of DayResult::activity
+enum Activity
+{
+	VOLUME,
+	INSERTS,
+	CANCELS,
+	AMENDS
+};
+
+void print_usage()
+{
+	cout << "Usage: replay [-j threads] [-o output] <file or glob>..." << endl;
+}
+
+/// Expands patterns which the shell did not expand, files that match nothing are kept as given
+vector<string> expand(const vector<string>& patterns)
+{
+	vector<string> files;
+
+	for (auto& pattern : patterns)
+	{
+		glob_t matches;
+		if (glob(pattern.c_str(), 0, nullptr, &matches) == 0)
+		{
+			for (size_t i = 0; i < matches.gl_pathc; i++)
+				files.push_back(matches.gl_pathv[i]);
+		}
+		else
+			files.push_back(pattern);
+
+		globfree(&matches);
+	}
+
+	return files;
+}
+
+size_t file_size(const string& file)
+{
+	struct stat info;
+	return stat(file.c_str(), &info) == 0 ? info.st_size : 0;
+}
+
+void replay_day(DayResult& result)
+{
+	ifstream infile(result.file);
+	result.is_open = infile.is_open();
+	if (!result.is_open)
+		return;
+
+	unique_ptr<DBManager> manager(new DBManager());
+	string order;
+
+	auto start = chrono::steady_clock::now();
+	while (getline(infile, order))
+	{
+		if (order.empty())
+			continue;
+
+		++result.events;
+		if (!manager->execute_command(order))
+			++result.rejected;
+	}
+	result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	for (auto& element : manager->get_orders_count())
+	{
+		result.orders_count[element.first] = element.second;
+
+		// Totals are kept apart from the ring of bars, so an old bar overwritten by a new one is still counted
+		const Bar total = manager->get_bar_total(element.first);
+		array<uint64_t, 4>& activity = result.activity[element.first];
+		activity[VOLUME] = total.volume;
+		activity[INSERTS] = total.inserts;
+		activity[CANCELS] = total.cancels;
+		activity[AMENDS] = total.amends;
+	}
+}
+
+void write_results(ostream& out, const vector<DayResult>& results)
+{
+	size_t events = 0;
+	size_t rejected = 0;
+	double seconds = 0;
+	map<string, size_t> orders_count;
+	map<string, array<uint64_t, 4>> activity;
+
+	out << "Days : " << endl;
+	out << "file\tevents\trejected\tseconds\tsymbols\topen orders" << endl;
+	for (auto& result : results)
+	{
+		if (!result.is_open)
+		{
+			out << result.file << "\tcan not open file" << endl;
+			continue;
+		}
+
+		size_t open_orders = 0;
+		for (auto& element : result.orders_count)
+		{
+			open_orders += element.second;
+			orders_count[element.first] += element.second;
+		}
+
+		for (auto& element : result.activity)
+			for (size_t i = 0; i < element.second.size(); i++)
+				activity[element.first][i] += element.second[i];
+
+		events += result.events;
+		rejected += result.rejected;
+		seconds += result.seconds;
+
+		out << result.file << "\t" << result.events << "\t" << result.rejected << "\t" << result.seconds << "\t"
+			<< result.orders_count.size() << "\t" << open_orders << endl;
+	}
+
+	out << "Combined : " << endl;
+	out << "symbol\topen orders\tvolume\tinserts\tcancels\tamends" << endl;
+	for (auto& element : activity)
+	{
+		out << element.first << "\t" << orders_count[element.first];
+		for (auto value : element.second)
+			out << "\t" << value;
+		out << endl;
+	}
+
+	out << "Total events : " << events << ", rejected : " << rejected << ", replay seconds (sum of days) : " << seconds << endl;
+}
+
+int main(int argc, char **argv)
+{
+	size_t thread_count = max(thread::hardware_concurrency(), 1u);
+	string output;
+	vector<string> patterns;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const string argument = argv[i];
+		if (argument == "-j" && i + 1 < argc)
+			thread_count = max(stoul(argv[++i]), 1ul);
+		else if (argument == "-o" && i + 1 < argc)
+			output = argv[++i];
+		else
+			patterns.push_back(argument);
+	}
+
+	const vector<string> files = expand(patterns);
+	if (files.empty())
+	{
+		print_usage();
+		return 0;
+	}
+
+	vector<DayResult> results(files.size());
+	for (size_t i = 0; i < files.size(); i++)
+		results[i].file = files[i];
+
+	// Biggest days first, so a big day is not left alone at the end
+	vector<size_t> schedule(files.size());
+	for (size_t i = 0; i < schedule.size(); i++)
+		schedule[i] = i;
+	stable_sort(schedule.begin(), schedule.end(), [&files](size_t a, size_t b) {
+		return file_size(files[a]) > file_size(files[b]);
+	});
+
+	auto start = chrono::steady_clock::now();
+	{
+		ThreadPool pool(min(thread_count, files.size()));
+		for (auto index : schedule)
+			pool.submit([&results, index] { replay_day(results[index]); });
+		pool.wait();
+	}
+	const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	if (output.empty())
+		write_results(cout, results);
+	else
+	{
+		ofstream outfile(output);
+		write_results(outfile, results);
+	}
+
+	cout << "Replayed " << files.size() << " files in " << seconds << " seconds" << endl;
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "../BarSeries.h"
+
+TEST(BarSeries, ohlcv)
+{
+	BarSeries series(1000000, 4);
+	series.on_insert(100, 10.0, 2);
+	series.on_insert(200, 12.0, 1);
+	series.on_amend(300, 8.0, 1);
+	series.on_cancel(400);
+
+	std::vector<Bar> bars = series.get_bars(4);
+
+	ASSERT_EQ(bars.size(), 1);
+	ASSERT_EQ(bars[0].start_time, 0);
+	ASSERT_DOUBLE_EQ(bars[0].open, 10.0);
+	ASSERT_DOUBLE_EQ(bars[0].high, 12.0);
+	ASSERT_DOUBLE_EQ(bars[0].low, 8.0);
+	ASSERT_DOUBLE_EQ(bars[0].close, 8.0);
+	ASSERT_EQ(bars[0].volume, 4);
+	ASSERT_DOUBLE_EQ(bars[0].vwap(), 10.0);
+	ASSERT_EQ(bars[0].inserts, 2);
+	ASSERT_EQ(bars[0].amends, 1);
+	ASSERT_EQ(bars[0].cancels, 1);
+}
+
+TEST(BarSeries, ring_overwrite)
+{
+	BarSeries series(10, 2);
+	series.on_insert(5, 1.0, 1);
+	series.on_insert(15, 2.0, 1);
+	series.on_insert(25, 3.0, 1);
+
+	BarColumns columns = series.get_columns();
+
+	ASSERT_EQ(series.size(), 2);
+	ASSERT_EQ(columns.start_time, std::vector<uint64_t>({10, 20}));
+	ASSERT_EQ(columns.open, std::vector<double>({2.0, 3.0}));
+}
+
+TEST(BarSeries, late_event)
+{
+	BarSeries series(10, 2);
+	series.on_insert(15, 2.0, 1);
+	series.on_insert(5, 1.0, 1);
+
+	ASSERT_EQ(series.size(), 1);
+	ASSERT_EQ(series.get_bars(1)[0].inserts, 2);
+}
+
+TEST(BarSeries, new_day)
+{
+	BarSeries series(10, 4);
+	series.on_insert(995, 2.0, 1);
+	series.on_insert(5, 1.0, 1);
+	series.on_insert(7, 3.0, 1);
+
+	std::vector<Bar> bars = series.get_bars(4);
+
+	ASSERT_EQ(bars.size(), 2);
+	ASSERT_EQ(bars[0].start_time, 990);
+	ASSERT_EQ(bars[0].inserts, 1);
+	ASSERT_EQ(bars[1].start_time, 0);
+	ASSERT_EQ(bars[1].inserts, 2);
+	ASSERT_DOUBLE_EQ(bars[1].open, 1.0);
+}
+
+TEST(BarSeries, total_outlives_ring)
+{
+	BarSeries series(10, 2);
+	for (uint64_t i = 0; i < 100; i++)
+		series.on_insert(5 + i * 10, 1.0 + i, 1);
+	series.on_cancel(995);
+
+	const Bar& total = series.get_total();
+
+	ASSERT_EQ(series.size(), 2);
+	ASSERT_EQ(total.start_time, 0);
+	ASSERT_EQ(total.inserts, 100);
+	ASSERT_EQ(total.cancels, 1);
+	ASSERT_EQ(total.volume, 100);
+	ASSERT_DOUBLE_EQ(total.open, 1.0);
+	ASSERT_DOUBLE_EQ(total.high, 100.0);
+}
@@ -36,3 +36,93 @@ TEST(DB, execute_update)
 
 	ASSERT_EQ(orders_count["DVAM1"], 2);
 }
+
+TEST(DB, bars)
+{
+	DBManager manager(1000000);
+	manager.execute_command("09:00:00.440000;DVAM1;2837174;I;SELL;72;36.30");
+	manager.execute_command("09:00:00.730000;DVAM1;2837176;I;SELL;5;36.60");
+	manager.execute_command("09:00:01.170000;DVAM1;2837174;A;SELL;72;36.00");
+	manager.execute_command("09:00:01.200000;DVAM1;2837176;C;SELL;5;36.60");
+
+	std::vector<Bar> bars = manager.get_bars("DVAM1");
+
+	ASSERT_EQ(bars.size(), 2);
+	ASSERT_EQ(bars[0].start_time, 32400000000);
+	ASSERT_DOUBLE_EQ(bars[0].high, 36.60);
+	ASSERT_EQ(bars[0].volume, 77);
+	ASSERT_EQ(bars[1].amends, 1);
+	ASSERT_EQ(bars[1].cancels, 1);
+	ASSERT_TRUE(manager.get_bars("NONE").empty());
+}
+
+TEST(DB, execute_malformed)
+{
+	DBManager manager;
+
+	ASSERT_FALSE(manager.execute_command("09:00:00.440000;DVAM1;2837174;I;SELL;72"));
+	ASSERT_FALSE(manager.execute_command("09:00:00.440000;DVAM1;2837174;I;SELL;72;36.30;1"));
+	ASSERT_FALSE(manager.execute_command("09:00:00.440000;DVAM1;28x7174;I;SELL;72;36.30"));
+	ASSERT_FALSE(manager.execute_command("09:00:00.440000;DVAM1;2837174;I;SELL;72;3a.30"));
+	ASSERT_FALSE(manager.execute_command("09:00:00.440000;DVAM1;2837174;X;SELL;72;36.30"));
+	ASSERT_FALSE(manager.execute_command("09:00:00.440000;DVAM1;2837174;I;SIDEWAYS;72;36.30"));
+	ASSERT_TRUE(manager.get_orders_count().empty());
+	ASSERT_TRUE(manager.execute_command("09:00:00.440000;DVAM1;2837174;I;SELL;72;36.30\r\n"));
+
+	const char buffer[] = "09:00:00.440000;DVAM2;2837175;I;BUY;9;9.60\n09:00:00.440000;DVAM2;2837176;I;BUY;7;9.60\n";
+	ASSERT_TRUE(manager.execute_command(buffer, 42));
+	ASSERT_EQ(manager.get_orders_count()["DVAM2"], 1);
+	ASSERT_EQ(manager.get_biggest_buy_order("DVAM2")[0], 9);
+}
+
+TEST(DB, compact)
+{
+	DBManager manager;
+	for (int i = 0; i < 100; i++)
+		manager.execute_command("23:59:58.440000;DVAM1;" + std::to_string(i) + ";I;BUY;" + std::to_string(i + 1) + ";36.10");
+	for (int i = 0; i < 95; i++)
+		manager.execute_command("23:59:58.500000;DVAM1;" + std::to_string(i) + ";C;BUY;1;36.10");
+
+	// Time going back over midnight and a sweep without commands keep the book
+	manager.execute_command("00:00:01.000000;DVAM2;1;I;SELL;3;9.60");
+	manager.compact("00:00:03.000000");
+	manager.compact("00:00:05.000000");
+
+	ASSERT_EQ(manager.get_orders_count()["DVAM1"], 5);
+	ASSERT_EQ(manager.get_biggest_buy_order("DVAM1", 2), std::vector<size_t>({100, 99}));
+	ASSERT_EQ(manager.get_depth("DVAM1", 1).bids[0].orders, 5);
+}
+
+TEST(DB, depth)
+{
+	DBManager manager;
+	manager.execute_command("09:00:00.440000;DVAM1;1;I;BUY;10;36.10");
+	manager.execute_command("09:00:00.440000;DVAM1;2;I;BUY;5;36.30");
+	manager.execute_command("09:00:00.440000;DVAM1;3;I;BUY;7;36.10");
+	manager.execute_command("09:00:00.440000;DVAM1;4;I;SELL;3;36.60");
+	manager.execute_command("09:00:00.440000;DVAM1;5;I;SELL;4;36.50");
+	manager.execute_command("09:00:00.440000;DVAM1;2;A;BUY;8;36.10");
+	manager.execute_command("09:00:00.440000;DVAM1;5;C;SELL;4;36.50");
+
+	DBManager::Depth depth = manager.get_depth("DVAM1", 5);
+
+	ASSERT_EQ(depth.bids.size(), 1);
+	ASSERT_DOUBLE_EQ(depth.bids[0].price, 36.10);
+	ASSERT_EQ(depth.bids[0].volume, 25);
+	ASSERT_EQ(depth.bids[0].orders, 3);
+	ASSERT_EQ(depth.asks.size(), 1);
+	ASSERT_DOUBLE_EQ(depth.asks[0].price, 36.60);
+	ASSERT_EQ(depth.asks[0].volume, 3);
+
+	// A reused depth keeps its storage
+	const PriceLevel* bids = depth.bids.data();
+	manager.execute_command("09:00:00.440000;DVAM1;3;C;BUY;7;36.10");
+	manager.get_depth("DVAM1", 5, depth);
+	ASSERT_EQ(depth.bids.data(), bids);
+	ASSERT_EQ(depth.bids[0].volume, 18);
+	ASSERT_EQ(depth.asks.size(), 1);
+
+	manager.get_depth("NONE", 5, depth);
+	ASSERT_TRUE(depth.bids.empty());
+	ASSERT_TRUE(depth.asks.empty());
+}
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "../Gateway.h"
+
+TEST(Gateway, answers_commands)
+{
+	const std::string path = "/tmp/gateway_test_" + std::to_string(getpid()) + ".sock";
+
+	std::unique_ptr<DBManager> manager(new DBManager());
+	Gateway gateway(*manager);
+	ASSERT_TRUE(gateway.listen_unix(path));
+
+	std::thread server([&gateway] { gateway.run(); });
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path.c_str());
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+	// Second command is split over two writes, third one is malformed
+	const std::string first = "09:00:00.440000;DVAM1;2837174;I;SELL;72;36.30\n09:00:00.690000;TEST8;28";
+	const std::string second = "37175;I;BUY;9;9.60\r\nbad command\n";
+	ASSERT_EQ(write(fd, first.data(), first.size()), first.size());
+	usleep(10000);
+	ASSERT_EQ(write(fd, second.data(), second.size()), second.size());
+
+	std::string answers;
+	char buffer[64];
+	while (answers.size() < 10)
+	{
+		ssize_t size = read(fd, buffer, sizeof(buffer));
+		ASSERT_GT(size, 0);
+		answers.append(buffer, size);
+	}
+	close(fd);
+
+	gateway.stop();
+	server.join();
+
+	ASSERT_EQ(answers, "OK\nOK\nERR\n");
+	ASSERT_EQ(gateway.get_commands_count(), 3);
+	ASSERT_EQ(manager->get_orders_count().size(), 2);
+}
+
+TEST(Gateway, answers_burst_larger_than_buffers)
+{
+	const std::string path = "/tmp/gateway_burst_" + std::to_string(getpid()) + ".sock";
+
+	std::unique_ptr<DBManager> manager(new DBManager());
+	Gateway gateway(*manager);
+	ASSERT_TRUE(gateway.listen_unix(path));
+
+	std::thread server([&gateway] { gateway.run(); });
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, path.c_str());
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	ASSERT_EQ(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+	// Answers are read only after all commands are written, so the gateway has to stop reading
+	const size_t count = 100000;
+	std::string commands;
+	for (size_t i = 0; i < count; ++i)
+		commands += "09:00:00.440000;SYM" + std::to_string(i % 50) + ";" + std::to_string(i) + ";I;SELL;72;36.30\n";
+	ASSERT_GT(commands.size(), 64 * 1024);
+
+	std::thread writer([fd, &commands]
+	{
+		for (size_t sent = 0; sent < commands.size();)
+		{
+			ssize_t size = write(fd, commands.data() + sent, commands.size() - sent);
+			if (size <= 0)
+				return;
+			sent += size;
+		}
+	});
+
+	usleep(200000);
+
+	std::string answers;
+	char buffer[4096];
+	while (answers.size() < 3 * count)
+	{
+		ssize_t size = read(fd, buffer, sizeof(buffer));
+		ASSERT_GT(size, 0);
+		answers.append(buffer, size);
+	}
+	writer.join();
+	close(fd);
+
+	gateway.stop();
+	server.join();
+
+	ASSERT_EQ(answers.find("ERR"), std::string::npos);
+	ASSERT_EQ(gateway.get_commands_count(), count);
+	ASSERT_EQ(manager->get_orders_count().size(), 50);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "../PriceLadder.h"
+
+TEST(PriceLadder, aggregate)
+{
+	PriceLadder ladder;
+	ladder.add(30, 3.0, 5);
+	ladder.add(10, 1.0, 2);
+	ladder.add(10, 1.0, 4);
+	ladder.add(20, 2.0, 1);
+
+	std::vector<PriceLevel> depth = ladder.get_depth(2);
+
+	ASSERT_EQ(ladder.size(), 3);
+	ASSERT_EQ(depth.size(), 2);
+	ASSERT_DOUBLE_EQ(depth[0].price, 1.0);
+	ASSERT_EQ(depth[0].volume, 6);
+	ASSERT_EQ(depth[0].orders, 2);
+	ASSERT_DOUBLE_EQ(depth[1].price, 2.0);
+}
+
+TEST(PriceLadder, depth_follows_changes)
+{
+	PriceLadder ladder;
+	ladder.add(10, 1.0, 2);
+	ladder.add(20, 2.0, 1);
+	ladder.add(30, 3.0, 5);
+	ASSERT_EQ(ladder.get_depth(3).size(), 3);
+
+	ladder.remove(20, 1);
+	ladder.add(30, 3.0, 1);
+
+	std::vector<PriceLevel> depth;
+	ladder.get_depth(3, depth);
+	ASSERT_EQ(depth.size(), 2);
+	ASSERT_DOUBLE_EQ(depth[1].price, 3.0);
+	ASSERT_EQ(depth[1].volume, 6);
+
+	ladder.add(5, 0.5, 1);
+	ladder.get_depth(1, depth);
+	ASSERT_EQ(depth.size(), 1);
+	ASSERT_DOUBLE_EQ(depth[0].price, 0.5);
+
+	ladder.get_depth(5, depth);
+	ASSERT_EQ(depth.size(), 3);
+	ASSERT_DOUBLE_EQ(depth[1].price, 1.0);
+	ASSERT_DOUBLE_EQ(depth[2].price, 3.0);
+}
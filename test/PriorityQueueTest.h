@@ -55,3 +55,77 @@ TEST(PriorityQueue, update)
 
 	ASSERT_EQ(queue.get_orders_count(), 1);
 }
+
+struct Quote
+{
+	int id;
+	uint32_t volume;
+	double price;
+	uint64_t timestamp;
+
+	int get_id() const
+	{
+		return id;
+	}
+};
+
+TEST(PriorityQueue, top_items)
+{
+	PriorityQueue<Item, int> queue;
+	for (int i = 0; i < 64; i++)
+		queue.insert({(i * 37) % 64, i});
+
+	std::vector<Item> top = queue.get_top_items(5);
+
+	ASSERT_EQ(top.size(), 5);
+	for (int i = 0; i < 5; i++)
+		ASSERT_EQ(top[i].data, 63 - i);
+}
+
+TEST(PriorityQueue, remove_keeps_index)
+{
+	PriorityQueue<Quote, int, MaxByVolume, 128> queue;
+	for (int i = 0; i < 100; i++)
+		queue.insert({i, static_cast<uint32_t>((i * 7919) % 101), 1.0, 0});
+	for (int i = 0; i < 100; i += 2)
+		queue.remove({i, 0, 0.0, 0});
+	for (int i = 1; i < 100; i += 4)
+		queue.update({i, 1000u + i, 1.0, 0});
+
+	std::vector<Quote> top = queue.get_top_items(100);
+
+	ASSERT_EQ(top.size(), 50);
+	ASSERT_EQ(top[0].id, 97);
+	for (size_t i = 1; i < top.size(); i++)
+		ASSERT_GE(top[i - 1].volume, top[i].volume);
+}
+
+TEST(PriorityQueue, policies)
+{
+	PriorityQueue<Quote, int, MaxByVolume, 16> by_volume;
+	PriorityQueue<Quote, int, MinByPrice, 16> by_min_price;
+	PriorityQueue<Quote, int, MaxByPrice, 16> by_max_price;
+	PriorityQueue<Quote, int, MinByPriceTime, 16> by_price_time;
+
+	const Quote quotes[] = {{1, 10, 36.3, 30}, {2, 50, 36.1, 20}, {3, 20, 36.1, 10}, {4, 5, 36.6, 40}};
+	for (auto& quote : quotes)
+	{
+		by_volume.insert(quote);
+		by_min_price.insert(quote);
+		by_max_price.insert(quote);
+		by_price_time.insert(quote);
+	}
+
+	ASSERT_EQ(by_volume.get_top_items(1)[0].id, 2);
+	ASSERT_DOUBLE_EQ(by_min_price.get_top_items(1)[0].price, 36.1);
+	ASSERT_EQ(by_max_price.get_top_items(1)[0].id, 4);
+	ASSERT_EQ(by_price_time.get_top_items(2)[0].id, 3);
+	ASSERT_EQ(by_price_time.get_top_items(2)[1].id, 2);
+}
+
+TEST(PriorityQueue, no_key_cache_for_items)
+{
+	// Keys of Natural ordering are the items themselves, so only integer keys are cached
+	ASSERT_LT(sizeof(PriorityQueue<Item, int, Natural, 64>), 80 * sizeof(Item));
+	ASSERT_GE(sizeof(PriorityQueue<Quote, int, MaxByVolume, 64>), 64 * sizeof(Quote) + 65 * sizeof(uint64_t));
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "../ThreadPool.h"
+
+TEST(ThreadPool, runs_all_tasks)
+{
+	std::atomic<size_t> count(0);
+	ThreadPool pool(4);
+
+	for (size_t i = 0; i < 1000; i++)
+		pool.submit([&count] { ++count; });
+	pool.wait();
+
+	ASSERT_EQ(count.load(), 1000);
+}
+
+TEST(ThreadPool, steals_from_busy_thread)
+{
+	std::atomic<size_t> count(0);
+	ThreadPool pool(2);
+
+	// Tasks are spread round robin, so the slow task holds one thread while its queue is stolen
+	pool.submit([] { std::this_thread::sleep_for(std::chrono::milliseconds(200)); });
+	for (size_t i = 0; i < 9; i++)
+		pool.submit([&count] { ++count; });
+
+	auto start = std::chrono::steady_clock::now();
+	while (count.load() != 9 && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(150))
+		std::this_thread::yield();
+
+	ASSERT_EQ(count.load(), 9);
+	pool.wait();
+}
+
+TEST(ThreadPool, starts_in_submit_order)
+{
+	std::atomic<bool> is_submitted(false);
+	std::mutex mutex;
+	std::vector<int> order;
+	ThreadPool pool(1);
+
+	// First task holds the thread until the others are queued
+	pool.submit([&is_submitted] {
+		while (!is_submitted.load())
+			std::this_thread::yield();
+	});
+
+	for (int i = 0; i < 5; i++)
+	{
+		pool.submit([&mutex, &order, i] {
+			std::lock_guard<std::mutex> lock(mutex);
+			order.push_back(i);
+		});
+	}
+
+	is_submitted = true;
+	pool.wait();
+
+	ASSERT_EQ(order, std::vector<int>({0, 1, 2, 3, 4}));
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <iostream>
+
+#include "../TieredBook.h"
+
+struct Ticket
+{
+	int id;
+	uint32_t volume;
+	uint64_t timestamp;
+
+	int get_id() const
+	{
+		return id;
+	}
+};
+
+struct TestTiering
+{
+	static constexpr size_t PROMOTE_COUNT = 4;
+	static constexpr size_t DEMOTE_COUNT = 2;
+	static constexpr size_t PROMOTE_RATE = 8;
+	static constexpr size_t DEMOTE_RATE = 2;
+	static constexpr uint64_t RATE_WINDOW = 1000;
+	static constexpr uint64_t ROLLOVER = 1000;
+};
+
+typedef TieredBook<Ticket, int, MaxByVolume, TestTiering, 64> TestBook;
+
+TEST(TieredBook, cold_order)
+{
+	TestBook book;
+	book.insert({1, 5, 0});
+	book.insert({2, 9, 0});
+	book.insert({3, 5, 0});
+	book.update({1, 1, 0});
+	book.remove({2, 0, 0});
+
+	std::vector<Ticket> top = book.get_top_items(3);
+
+	ASSERT_FALSE(book.is_hot());
+	ASSERT_EQ(top.size(), 2);
+	ASSERT_EQ(top[0].id, 3);
+	ASSERT_EQ(top[1].id, 1);
+	ASSERT_EQ(book.find(1)->volume, 1);
+	ASSERT_EQ(book.find(2), nullptr);
+	ASSERT_FALSE(book.insert({3, 7, 0}));
+}
+
+TEST(TieredBook, promote_and_demote_by_count)
+{
+	TestBook book;
+	for (int i = 0; i < 5; i++)
+		book.insert({i, static_cast<uint32_t>(i), static_cast<uint64_t>(i * 400)});
+
+	ASSERT_TRUE(book.is_hot());
+	ASSERT_EQ(book.get_top_items(1)[0].id, 4);
+
+	for (int i = 0; i < 4; i++)
+		book.remove({i, 0, 3000});
+
+	// The window of removes is still busy, the one after it is quiet
+	book.update({4, 2, 5000});
+	ASSERT_TRUE(book.is_hot());
+	book.update({4, 3, 7000});
+
+	ASSERT_FALSE(book.is_hot());
+	ASSERT_EQ(book.get_orders_count(), 1);
+	ASSERT_EQ(book.find(4)->volume, 3);
+}
+
+TEST(TieredBook, promote_by_rate)
+{
+	TestBook book;
+	book.insert({1, 1, 0});
+	for (uint32_t i = 0; i < 8; i++)
+		book.update({1, i, 10});
+
+	ASSERT_TRUE(book.is_hot());
+	ASSERT_EQ(book.get_orders_count(), 1);
+	ASSERT_GT(book.get_memory_usage(), sizeof(PriorityQueue<Ticket, int, MaxByVolume, 64>));
+}
+
+TEST(TieredBook, time_going_back_starts_window)
+{
+	TestBook book;
+	for (uint32_t i = 0; i < 10; i++)
+		book.insert({static_cast<int>(i), i, 1500});
+	for (int i = 0; i < 9; i++)
+		book.remove({i, 0, 1500});
+	ASSERT_TRUE(book.is_hot());
+
+	// A small step back counts in the busy window
+	book.update({9, 1, 1000});
+	book.update({9, 1, 2400});
+	ASSERT_TRUE(book.is_hot());
+
+	// A new day starts a busy window, the one after it is quiet
+	book.update({9, 1, 100});
+	ASSERT_TRUE(book.is_hot());
+	book.update({9, 2, 1200});
+
+	ASSERT_FALSE(book.is_hot());
+	ASSERT_EQ(book.find(9)->volume, 2);
+}
+
+TEST(TieredBook, compact_demotes_idle_book)
+{
+	TestBook book;
+	book.insert({1, 1, 0});
+	for (uint32_t i = 0; i < 8; i++)
+		book.update({1, i, 10});
+	ASSERT_TRUE(book.is_hot());
+
+	book.compact(500);
+	ASSERT_TRUE(book.is_hot());
+
+	// The busy window ends first, then a window without any operation
+	book.compact(1010);
+	ASSERT_TRUE(book.is_hot());
+	book.compact(2010);
+
+	ASSERT_FALSE(book.is_hot());
+	ASSERT_EQ(book.get_orders_count(), 1);
+	ASSERT_EQ(book.find(1)->volume, 7);
+}
@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include <iostream>
 
+#include "BarSeriesTest.h"
 #include "DBManagerTest.h"
+#include "GatewayTest.h"
+#include "PriceLadderTest.h"
 #include "PriorityQueueTest.h"
+#include "ThreadPoolTest.h"
+#include "TieredBookTest.h"
 
 int main(int argc, char** argv)
 {